@@ -19,8 +19,6 @@
 #include "systems/ControllableActorSystem.hpp"
 #include "systems/NavigationGridSystem.hpp"
 
-#include <algorithm>
-
 #ifndef FLT_MAX
 #define FLT_MAX                                                                                                   \
     340282346638528859811704183484516925440.0f // Maximum value of a float, from bit
@@ -213,7 +211,7 @@ namespace sage
         }
         GridSquare dest{};
         sys->navigationGridSystem->WorldToGridSpace(mouseHit, dest);
-        if (sys->navigationGridSystem->GetGridSquare(dest.row, dest.col)->occupied)
+        if (sys->navigationGridSystem->CheckSingleSquareOccupied(dest))
         {
             return false;
         }
@@ -302,33 +300,11 @@ namespace sage
         auto viewport = sys->settings->GetViewPort();
         // Get ray and test against objects
         ray = GetScreenToWorldRayEx(GetMousePosition(), *sys->camera->getRaylibCam(), viewport.x, viewport.y);
-        auto collisions = sys->collisionSystem->GetCollisionsWithRay(ray);
-
-        // Replace floor BB hit with mesh hit then re-sort vector
-        // Discards hits with a BB that do not have a collision with mesh
-        for (auto it = collisions.begin(); it != collisions.end();)
-        {
-            if (it->collisionLayer == CollisionLayer::FLOORCOMPLEX || it->collisionLayer == CollisionLayer::STAIRS)
-            {
-                if (!findMeshCollision(*it))
-                {
-                    it = collisions.erase(it);
-                    continue;
-                }
-            }
-
-            ++it;
-        }
-
-        if (collisions.empty()) // Could put this sooner, but would need to repeat after above
+        if (!sys->collisionSystem->GetFirstCollisionWithRay(ray, m_mouseHitInfo))
         {
             return;
         }
 
-        CollisionSystem::SortCollisionsByDistance(collisions);
-
-        m_mouseHitInfo = collisions[0];
-
         if (m_mouseHitInfo.collisionLayer == CollisionLayer::FLOORSIMPLE ||
             m_mouseHitInfo.collisionLayer == CollisionLayer::FLOORCOMPLEX ||
             m_mouseHitInfo.collisionLayer == CollisionLayer::STAIRS)
@@ -337,17 +313,8 @@ namespace sage
         }
         else
         {
-            // Find first navigation collision (if any)
-            const auto navIt = std::find_if(collisions.begin(), collisions.end(), [](const CollisionInfo& coll) {
-                return coll.collisionLayer == CollisionLayer::FLOORSIMPLE ||
-                       coll.collisionLayer == CollisionLayer::FLOORCOMPLEX ||
-                       coll.collisionLayer == CollisionLayer::STAIRS;
-            });
-
-            if (navIt != collisions.end())
-            {
-                m_naviHitInfo = *navIt;
-            }
+            // Find first navigation collision (if any). The NAVIGATION layer collides with just the floor layers.
+            sys->collisionSystem->GetFirstCollisionWithRay(ray, m_naviHitInfo, CollisionLayer::NAVIGATION);
         }
 
         onCollisionHit.Publish(m_mouseHitInfo.collidedEntityId);
@@ -363,28 +330,6 @@ namespace sage
         hitInfo.rlCollision.hit = false;
     }
 
-    // Find the model's mesh collision (instead of using its bounding box)
-    bool Cursor::findMeshCollision(CollisionInfo& hitInfo) const
-    {
-        if (registry->any_of<Renderable>(hitInfo.collidedEntityId))
-        {
-            const auto& renderable = registry->get<Renderable>(hitInfo.collidedEntityId);
-            const auto& transform = registry->get<sgTransform>(hitInfo.collidedEntityId);
-
-            for (int i = 0; i < renderable.GetModel()->GetMeshCount(); ++i)
-            {
-                if (const auto meshCollision =
-                        renderable.GetModel()->GetRayMeshCollision(ray, i, transform.GetMatrix());
-                    meshCollision.hit)
-                {
-                    hitInfo.rlCollision = meshCollision;
-                    return true;
-                }
-            }
-        }
-        return false;
-    }
-
     const CollisionInfo& Cursor::getMouseHitInfo() const
     {
         return m_mouseHitInfo;
@@ -61,7 +61,6 @@ namespace sage
         void onMouseRightDown() const;
         void changeCursors(CollisionLayer collisionLayer);
         static void resetHitInfo(CollisionInfo& hitInfo);
-        [[nodiscard]] bool findMeshCollision(CollisionInfo& hitInfo) const;
 
       public:
         std::string hitObjectName{};
@@ -60,9 +60,7 @@ namespace sage
         auto& transform = registry->get<sgTransform>(entity);
         GridSquare actorIdx{};
         sys->navigationGridSystem->WorldToGridSpace(position, actorIdx);
-        auto gs = sys->navigationGridSystem->GetGridSquare(actorIdx.row, actorIdx.col);
-        assert(gs);
-        float height = gs->GetTerrainHeight();
+        float height = sys->navigationGridSystem->GetTerrainHeight(actorIdx);
         transform.SetPosition({position.x, height, position.z});
     }
 
@@ -275,8 +273,7 @@ namespace sage
             auto& transform = registry->emplace<sgTransform>(id, id);
             GridSquare actorIdx{};
             sys->navigationGridSystem->WorldToGridSpace(position, actorIdx);
-            float height =
-                sys->navigationGridSystem->GetGridSquare(actorIdx.row, actorIdx.col)->GetTerrainHeight();
+            float height = sys->navigationGridSystem->GetTerrainHeight(actorIdx);
             transform.SetPosition({position.x, 12, position.z});
             transform.SetScale(1.0f);
             transform.SetRotation({0, 0, 0});
@@ -320,7 +317,7 @@ namespace sage
         auto& transform = registry->emplace<sgTransform>(id, id);
         GridSquare actorIdx{};
         sys->navigationGridSystem->WorldToGridSpace(position, actorIdx);
-        float height = sys->navigationGridSystem->GetGridSquare(actorIdx.row, actorIdx.col)->GetTerrainHeight();
+        float height = sys->navigationGridSystem->GetTerrainHeight(actorIdx);
         transform.SetPosition({position.x, height, position.z});
         transform.SetScale(10.0f);
         transform.SetRotation({0, 0, 0});
@@ -344,7 +341,7 @@ namespace sage
         auto& transform = registry->emplace<sgTransform>(id, id);
         GridSquare actorIdx{};
         sys->navigationGridSystem->WorldToGridSpace(position, actorIdx);
-        float height = sys->navigationGridSystem->GetGridSquare(actorIdx.row, actorIdx.col)->GetTerrainHeight();
+        float height = sys->navigationGridSystem->GetTerrainHeight(actorIdx);
         transform.SetPosition({position.x, height, position.z});
         transform.SetScale(1.0f);
         transform.SetRotation({0, 0, 0});
@@ -369,6 +369,20 @@ namespace sage
         }
     }
 
+    void ResourceManager::HeightfieldLoad(const std::string& key, Heightfield heightfield)
+    {
+        if (!heightfields.contains(key))
+        {
+            heightfields.emplace(key, std::move(heightfield));
+        }
+    }
+
+    const Heightfield* ResourceManager::GetHeightfield(const std::string& key) const
+    {
+        const auto it = heightfields.find(key);
+        return it != heightfields.end() ? &it->second : nullptr;
+    }
+
     void ResourceManager::ModelLoadFromFile(const std::string& path)
     {
         auto pathDealiased =
@@ -397,7 +411,8 @@ namespace sage
                 model.materials[i] = materialMap.at(mat);
             }
 
-            modelCopies.emplace(key, std::move(ModelInfo{model, materialNames}));
+            modelCopies.emplace(
+                key, std::move(ModelInfo{.model = model, .materialNames = materialNames, .meshBvhs = {}}));
         }
     }
 
@@ -435,6 +450,28 @@ namespace sage
         return ModelSafe(model);
     }
 
+    std::shared_ptr<const TriangleBvh> ResourceManager::GetMeshBvh(
+        const std::string& key, const int meshNum, const Mesh& mesh)
+    {
+        {
+            std::lock_guard lock(meshBvhMutex);
+            const auto it = modelCopies.find(key);
+            if (it == modelCopies.end()) return nullptr;
+            auto& info = it->second;
+            if (meshNum >= info.model.meshCount || info.model.meshes[meshNum].vertices != mesh.vertices)
+                return nullptr;
+            info.meshBvhs.resize(info.model.meshCount);
+            if (info.meshBvhs[meshNum]) return info.meshBvhs[meshNum];
+        }
+
+        // Built outside the lock, so that the meshes of different models can be built at the same time
+        auto bvh = std::make_shared<const TriangleBvh>(mesh);
+        std::lock_guard lock(meshBvhMutex);
+        auto& shared = modelCopies.at(key).meshBvhs[meshNum];
+        if (!shared) shared = std::move(bvh);
+        return shared;
+    }
+
     void ResourceManager::ModelAnimationLoadFromFile(const std::string& path)
     {
         auto pathDealiased =
@@ -557,6 +594,7 @@ namespace sage
         modelCopies.clear();
         nonModelTextures.clear();
         images.clear();
+        heightfields.clear();
         modelAnimations.clear();
         shaders.clear();
         vertShaderFileText.clear();
@@ -5,6 +5,8 @@
 
 #include "common_types.hpp"
 #include "slib.hpp"
+#include "systems/navigation/Heightfield.hpp"
+#include "TriangleBvh.hpp"
 
 #include "magic_enum/magic_enum.hpp"
 #include "raylib.h"
@@ -18,6 +20,9 @@
 #include "cereal/types/vector.hpp"
 #include "raylib-cereal.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -28,6 +33,8 @@ namespace sage
         Model model;
         std::vector<std::string>
             materialNames; // names of this mesh's materials (at the same index in model.materials)
+        // Per mesh, built on first use (see ResourceManager::GetMeshBvh). Not serialised.
+        std::vector<std::shared_ptr<const TriangleBvh>> meshBvhs;
 
         template <class Archive>
         void save(Archive& archive) const
@@ -52,6 +59,7 @@ namespace sage
         std::unordered_map<std::string, Shader> shaders{};
         std::unordered_map<std::string, Material> materialMap;
         std::unordered_map<std::string, Image> images{};             // Image (CPU) data
+        std::unordered_map<std::string, Heightfield> heightfields{};
         std::unordered_map<std::string, Texture> nonModelTextures{}; // Textures loaded outside of model loading
         std::unordered_map<std::string, ModelInfo> modelCopies{};
         std::unordered_map<std::string, std::pair<ModelAnimation*, int>> modelAnimations{};
@@ -59,6 +67,12 @@ namespace sage
         std::unordered_map<std::string, char*> fragShaderFileText{};
         std::unordered_map<std::string, Music> music;
         std::unordered_map<std::string, Sound> sfx;
+        std::mutex meshBvhMutex;
+
+        // Packs from before FORMAT_VERSION start with the image count instead, which is never this large
+        static constexpr uint64_t FORMAT_MAGIC = 0x53414745'5245534FULL;
+        // 1: heightfields
+        static constexpr uint32_t FORMAT_VERSION = 1;
 
         Shader gpuShaderLoad(const char* vs, const char* fs);
         static void deepCopyModel(const Model& oldModel, Model& newModel);
@@ -83,9 +97,15 @@ namespace sage
         void FontLoadFromFile(const std::string& path);
         void ImageLoadFromFile(const std::string& path);
         void ImageLoadFromFile(const std::string& path, Image image);
+        void HeightfieldLoad(const std::string& key, Heightfield heightfield);
+        // nullptr if the key does not exist (e.g., maps packed before FORMAT_VERSION 1)
+        [[nodiscard]] const Heightfield* GetHeightfield(const std::string& key) const;
         void ModelLoadFromFile(const std::string& path);
         [[nodiscard]] ModelSafe GetModelCopy(const std::string& key);
         [[nodiscard]] ModelSafe GetModelDeepCopy(const std::string& key) const;
+        // Built on first use and shared by shallow copies. Null if "mesh" is not one of the model's meshes.
+        [[nodiscard]] std::shared_ptr<const TriangleBvh> GetMeshBvh(
+            const std::string& key, int meshNum, const Mesh& mesh);
         void ModelAnimationLoadFromFile(const std::string& path);
         ModelAnimation* GetModelAnimation(const std::string& key, int* animsCount);
         void UnloadImages();
@@ -112,12 +132,15 @@ namespace sage
             }
 
             archive(
+                FORMAT_MAGIC,
+                FORMAT_VERSION,
                 GetInstance().images,
                 GetInstance().modelCopies,
                 GetInstance().materialMap,
                 animatedModelKeys,
                 modelAnimCounts,
-                modelAnimationsData);
+                modelAnimationsData,
+                GetInstance().heightfields);
 
             //
         }
@@ -133,18 +156,45 @@ namespace sage
             std::unordered_map<std::string, Image> _images{};
             std::unordered_map<std::string, ModelInfo> _modelCopies{};
             std::unordered_map<std::string, Material> _materialMap;
+            std::unordered_map<std::string, Heightfield> _heightfields{};
+
+            uint64_t magic = 0;
+            uint32_t version = 0;
+            archive(magic);
+            if (magic == FORMAT_MAGIC)
+            {
+                archive(version, _images);
+            }
+            else
+            {
+                // Unversioned pack: "magic" was the size of the images map. Reads the rest of the map as the
+                // binary archive lays it out, a key then a value per entry.
+                for (uint64_t i = 0; i < magic; ++i)
+                {
+                    std::string key;
+                    Image image;
+                    archive(key, image);
+                    _images.emplace(std::move(key), image);
+                }
+            }
 
-            archive(_images, _modelCopies, _materialMap, animatedModelKeys, modelAnimCounts, modelAnimationsData);
+            archive(_modelCopies, _materialMap, animatedModelKeys, modelAnimCounts, modelAnimationsData);
+            if (version >= 1)
+            {
+                archive(_heightfields);
+            }
 
             // WARNING: Does *not* account for overlapping keys (does nothing if key exists)
             images.merge(_images);
             modelCopies.merge(_modelCopies);
             materialMap.merge(_materialMap);
+            heightfields.merge(_heightfields);
 
             // Merge leaves overlapping keys in the previous map. Ensure none are overlapping.
             assert(_images.empty());
             assert(_modelCopies.empty());
             assert(_materialMap.empty());
+            assert(_heightfields.empty());
 
             for (auto& [key, model] : modelCopies)
             {
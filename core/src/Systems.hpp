@@ -68,6 +68,7 @@ namespace sage
         std::unique_ptr<RenderSystem> renderSystem;
         std::unique_ptr<CollisionSystem> collisionSystem;
         std::unique_ptr<NavigationGridSystem> navigationGridSystem;
+        // Destroyed before navigationGridSystem, which its pathfinding workers read
         std::unique_ptr<ActorMovementSystem> actorMovementSystem;
         std::unique_ptr<ControllableActorSystem> controllableActorSystem;
         std::unique_ptr<AnimationSystem> animationSystem;
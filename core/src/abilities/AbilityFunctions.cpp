@@ -10,37 +10,57 @@
 #include "components/CombatableActor.hpp"
 #include "components/sgTransform.hpp"
 #include "systems/ActorMovementSystem.hpp"
+#include "systems/CollisionSystem.hpp"
 
 #include "vfx/RainOfFireVFX.hpp"
 
 #include "raymath.h"
+#include <array>
 #include <iostream>
 #include <memory>
 
 namespace sage
 {
+    namespace
+    {
+        constexpr size_t MAX_AOE_TARGETS = 128;
+    }
+
     void AOEAtPoint(
-        entt::registry* registry, entt::entity caster, entt::entity abilityEntity, Vector3 point, float radius)
+        entt::registry* registry,
+        Systems* sys,
+        entt::entity caster,
+        entt::entity abilityEntity,
+        Vector3 point,
+        float radius)
     {
         auto& abilityData = registry->get<Ability>(abilityEntity).ad;
-        auto view = registry->view<CombatableActor>();
-        for (auto& entity : view)
-        {
-            if (entity == caster) continue;
+        const Vector3 extent{radius, radius, radius};
+        const BoundingBox area{Vector3Subtract(point, extent), Vector3Add(point, extent)};
 
-            const auto& targetTransform = registry->get<sgTransform>(entity);
-            const auto& targetCol = registry->get<Collideable>(entity);
+        // Only the collideables near the point are visited, rather than every combatable actor. Hits are
+        // gathered first, as a hit can destroy its target (and change the collision trees mid-query).
+        std::array<entt::entity, MAX_AOE_TARGETS> targets{};
+        size_t count = 0;
+        auto* collisionSystem = sys->collisionSystem.get();
+        collisionSystem->ForEachCollisionWithBoundingBox(area, CollisionLayer::DEFAULT, [&](const auto& info) {
+            const auto entity = info.collidedEntityId;
+            if (entity == caster || !registry->any_of<CombatableActor>(entity)) return true;
+            if (!CheckCollisionBoxSphere(info.collidedBB, point, radius)) return true;
+            targets[count++] = entity;
+            return count < targets.size();
+        });
 
-            if (CheckCollisionBoxSphere(targetCol.worldBoundingBox, point, radius))
-            {
-                const auto& combatable = registry->get<CombatableActor>(entity);
-                AttackData attackData{
-                    .attacker = caster,
-                    .hit = entity,
-                    .damage = abilityData.base.baseDamage,
-                    .elements = abilityData.base.elements};
-                combatable.onHit.Publish(attackData);
-            }
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!registry->valid(targets[i])) continue;
+            const auto& combatable = registry->get<CombatableActor>(targets[i]);
+            AttackData attackData{
+                .attacker = caster,
+                .hit = targets[i],
+                .damage = abilityData.base.baseDamage,
+                .elements = abilityData.base.elements};
+            combatable.onHit.Publish(attackData);
         }
     }
 
@@ -6,8 +6,15 @@
 
 namespace sage
 {
+    class Systems;
+
     void AOEAtPoint(
-        entt::registry* registry, entt::entity caster, entt::entity abilityEntity, Vector3 point, float radius);
+        entt::registry* registry,
+        Systems* sys,
+        entt::entity caster,
+        entt::entity abilityEntity,
+        Vector3 point,
+        float radius);
 
     void HitSingleTarget(
         entt::registry* registry, entt::entity caster, entt::entity abilityEntity, entt::entity target);
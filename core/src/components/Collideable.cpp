@@ -16,6 +16,8 @@ namespace sage
         auto& trans = registry->get<sgTransform>(self);
         Matrix mat = trans.GetMatrixNoRot(); // AABB, so no rotation
         SetWorldBoundingBox(mat);
+        // Lets on_update listeners (e.g., CollisionSystem's dynamic tree) know that the box has moved
+        registry->patch<Collideable>(self);
     }
 
     void Collideable::SetWorldBoundingBox(Matrix mat)
@@ -36,6 +38,11 @@ namespace sage
         active = false;
     }
 
+    bool Collideable::IsDynamic() const
+    {
+        return registry != nullptr;
+    }
+
     Collideable::Collideable(const BoundingBox& _localBoundingBox, const Matrix& worldMatrix)
         : localBoundingBox(_localBoundingBox)
     {
@@ -64,6 +64,8 @@ namespace sage
         void SetWorldBoundingBox(Matrix mat);
         void Enable();
         void Disable();
+        // Follows its entity's transform (as opposed to being placed once, like the map's static meshes)
+        [[nodiscard]] bool IsDynamic() const;
 
         // Static object
         explicit Collideable(const BoundingBox& _localBoundingBox, const Matrix& worldMatrix);
@@ -51,12 +51,22 @@ namespace sage
         float movementSpeed = 0.35f;
         // The max range the actor can pathfind at one time.
         int pathfindingBounds = 50;
+        // If above zero, paths are curved through their turns, with a waypoint this far apart (see CurvePath).
+        float pathCurveSpacing = 0;
         // std::optional<MoveableActorCollision> moveableActorCollision;
         entt::entity hitEntityId = entt::null;
         Vector3 hitLastPos{};
         std::optional<FollowTarget> followTarget;
         std::optional<entt::entity> lootTarget;
         std::deque<Vector3> path{};
+        // While set, the path is extended from this entity's flow field
+        entt::entity flowFieldTarget = entt::null;
+        // Actors planned together, e.g., a party or a wave (see ActorMovementSystem::PathfindToLocationInGroup)
+        entt::entity movementGroup = entt::null;
+        // Frames left to wait on a cooperative path
+        int waitFrames = 0;
+        // Frames held up by another actor on a cooperative path
+        int blockedFrames = 0;
 
         Event<entt::entity> onStartMovement{};
         Event<entt::entity> onDestinationReached{};
@@ -75,6 +85,8 @@ namespace sage
             return path.back();
         }
 
+        // Squares visited by the actor's last collision ray. Only recorded if debugRayEnabled is set.
+        bool debugRayEnabled = false;
         std::vector<GridSquare> debugRay;
     };
 } // namespace sage
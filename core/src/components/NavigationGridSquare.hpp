@@ -7,10 +7,16 @@
 #include "raylib.h"
 #include "raymath.h"
 #include "entt/entt.hpp"
-#include <optional>
+
+#include <cassert>
+#include <limits>
+#include <tuple>
 
 namespace sage
 {
+    // Sentinel for a grid square that has not (yet) been given a terrain height.
+    constexpr float NAVIGATION_GRID_NO_HEIGHT = std::numeric_limits<float>::lowest();
+
     struct GridSquare
     {
         int row;
@@ -59,44 +65,41 @@ namespace sage
         }
     };
 
+    // Debug state of a grid square, kept apart from the pathfinding data
+    struct NavigationGridSquareDebug
+    {
+        bool drawDebug = false;
+        Color debugColor = RED;
+
+        bool operator==(const NavigationGridSquareDebug& other) const
+        {
+            return drawDebug == other.drawDebug && debugColor.r == other.debugColor.r &&
+                   debugColor.g == other.debugColor.g && debugColor.b == other.debugColor.b &&
+                   debugColor.a == other.debugColor.a;
+        }
+    };
+
+    // Snapshot of a single grid square, assembled by NavigationGridSystem::GetGridSquare
     struct NavigationGridSquare
     {
       private:
-        std::optional<float> terrainHeight;
+        float terrainHeight = NAVIGATION_GRID_NO_HEIGHT;
 
       public:
         int pathfindingCost = 1;
-        bool drawDebug = false;
-        Color debugColor = RED;
-        GridSquare gridSquareIndex;
-        Vector3 worldPosMin; // Top Left
-        Vector3 worldPosMax; // Bottom Right
-        Vector3 worldPosCentre;
-        Vector3 debugBox;
+        GridSquare gridSquareIndex{};
+        Vector3 worldPosMin{}; // Top Left
+        Vector3 worldPosMax{}; // Bottom Right
+        Vector3 worldPosCentre{};
         entt::entity occupant = entt::null;
         bool occupied = false;
 
         Vector3 terrainNormal = {0, 1, 0};
 
-        void SetTerrainHeight(float _terrainHeight)
-        {
-            terrainHeight = _terrainHeight;
-        }
-
         [[nodiscard]] float GetTerrainHeight() const
         {
-            assert(terrainHeight.has_value());
-            return *terrainHeight;
-        }
-
-        NavigationGridSquare(
-            GridSquare _gridSquareIndex, Vector3 _worldPosMin, Vector3 _worldPosMax, Vector3 _worldPosCentre)
-            : gridSquareIndex(_gridSquareIndex),
-              worldPosMin(_worldPosMin),
-              worldPosMax(_worldPosMax),
-              worldPosCentre(_worldPosCentre),
-              debugBox({fabsf(worldPosMax.x - worldPosMin.x), 0.1f, fabsf(worldPosMax.z - worldPosMin.z)})
-        {
+            assert(terrainHeight != NAVIGATION_GRID_NO_HEIGHT);
+            return terrainHeight;
         }
 
         friend class NavigationGridSystem;
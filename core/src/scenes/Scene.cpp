@@ -6,6 +6,7 @@
 #include "AudioManager.hpp"
 #include "Camera.hpp"
 
+#include "components/MoveableActor.hpp"
 #include "components/Renderable.hpp"
 #include "components/Spawner.hpp"
 #include "components/UberShaderComponent.hpp"
@@ -32,6 +33,7 @@ namespace sage
     void Scene::loadSpawners() const
     {
         entt::entity firstPlayer = entt::null;
+        entt::entity wave = entt::null; // Enemies spawned together move as one group
         const auto spawnerView = registry->view<Spawner>();
         for (auto& entity : spawnerView)
         {
@@ -43,7 +45,10 @@ namespace sage
             }
             else if (spawner.type == SpawnerType::ENEMY)
             {
-                GameObjectFactory::createEnemy(registry, sys.get(), spawner.pos, spawner.rot, "Goblin");
+                const auto enemy =
+                    GameObjectFactory::createEnemy(registry, sys.get(), spawner.pos, spawner.rot, "Goblin");
+                if (wave == entt::null) wave = registry->create();
+                registry->get<MoveableActor>(enemy).movementGroup = wave;
             }
             else if (spawner.type == SpawnerType::NPC)
             {
@@ -65,11 +70,21 @@ namespace sage
         serializer::DeserializeJsonFile<LootTable>("resources/loot-table.json", *sys->lootTable);
         // serializer::SaveClassJson<LootTable>("resources/loot-table.json", *sys->lootTable);
 
-        const auto heightMap = ResourceManager::GetInstance().GetImage("HEIGHT_MAP");
-        const auto normalMap = ResourceManager::GetInstance().GetImage("NORMAL_MAP");
-        const auto slices = heightMap.GetWidth();
-        sys->navigationGridSystem->Init(slices, 1.0f);
-        sys->navigationGridSystem->PopulateGrid(heightMap, normalMap);
+        if (const auto* heightfield = ResourceManager::GetInstance().GetHeightfield("HEIGHTFIELD"))
+        {
+            sys->navigationGridSystem->Init(heightfield->slices, 1.0f);
+            sys->navigationGridSystem->PopulateGrid(*heightfield);
+        }
+        else
+        {
+            const auto heightMap = ResourceManager::GetInstance().GetImage("HEIGHT_MAP");
+            const auto normalMap = ResourceManager::GetInstance().GetImage("NORMAL_MAP");
+            const auto slices = heightMap.GetWidth();
+            sys->navigationGridSystem->Init(slices, 1.0f);
+            sys->navigationGridSystem->PopulateGrid(heightMap, normalMap);
+        }
+        // Spawners have not run yet, so only the map's own (static) collideables go in the BVH
+        sys->collisionSystem->BuildStaticBvh();
 
         // NB: Dependent on *only* the map/static meshes having been loaded at this point
         for (const auto view = registry->view<Renderable>(); auto entity : view)
@@ -127,6 +142,7 @@ namespace sage
         sys->cursorClickIndicator->Update();
         sys->fullscreenTextOverlayFactory->Update();
         sys->actorMovementSystem->Update();
+        sys->navigationGridSystem->StreamTerrain(sys->camera->getRaylibCam()->target);
         sys->controllableActorSystem->Update();
         sys->dialogSystem->Update();
         sys->healthBarSystem->Update();
@@ -10,8 +10,11 @@
 #include "slib.hpp"
 #include "Systems.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <format>
 #include <ranges>
+#include <thread>
 #include <tuple>
 
 namespace sage
@@ -19,14 +22,20 @@ namespace sage
 
     void ActorMovementSystem::PruneMoveCommands(const entt::entity& entity) const
     {
+        pathfindingJobs->Cancel(entity);
+        leaveCooperativeGroup(entity);
         auto& actor = registry->get<MoveableActor>(entity);
         std::deque<Vector3> empty;
         std::swap(actor.path, empty);
+        actor.flowFieldTarget = entt::null;
+        actor.waitFrames = 0;
+        actor.blockedFrames = 0;
     }
 
     void ActorMovementSystem::CancelMovement(const entt::entity& entity) const
     {
         PruneMoveCommands(entity);
+        erasePlanner(entity);
         auto& moveable = registry->get<MoveableActor>(entity);
         moveable.onMovementCancel.Publish(entity);
     }
@@ -53,11 +62,16 @@ namespace sage
     {
         PathfindToLocation(entity, destination, astar);
         auto& moveable = registry->get<MoveableActor>(entity);
-        return moveable.IsMoving();
+        return moveable.IsMoving() || IsPathfindPending(entity);
     }
 
-    void ActorMovementSystem::PathfindToLocation(
-        const entt::entity& entity, const Vector3& destination, bool astar) const
+    // Publishes onDestinationUnreachable if the actor cannot pathfind to the destination
+    bool ActorMovementSystem::validateDestination(
+        const entt::entity& entity,
+        const Vector3& destination,
+        const bool astar,
+        GridSquare& minRange,
+        GridSquare& maxRange) const
     {
         auto& moveable = registry->get<MoveableActor>(entity);
 
@@ -72,11 +86,9 @@ namespace sage
             // std::cout << std::format(
             // "Entity {}: Requested destination out of grid bounds \n", static_cast<int>(entity));
 
-            return;
+            return false;
         }
 
-        GridSquare minRange{};
-        GridSquare maxRange{};
         if (!sys->navigationGridSystem->GetPathfindRange(entity, moveable.pathfindingBounds, minRange, maxRange))
         {
             // This will very rarely happen. Only triggers if the entity's current position is outside of grid
@@ -88,10 +100,11 @@ namespace sage
             // std::cout << std::format(
             // "Entity {}: Current position out of grid bounds \n", static_cast<int>(entity));
             moveable.onDestinationUnreachable.Publish(entity, destination);
-            return;
+            return false;
         }
 
-        if (!sys->navigationGridSystem->CheckWithinBounds(destination, minRange, maxRange))
+        // Only the BFS path is range limited
+        if (!astar && !sys->navigationGridSystem->CheckWithinBounds(destination, minRange, maxRange))
         {
             if (entity == sys->controllableActorSystem->GetSelectedActor())
             {
@@ -100,34 +113,251 @@ namespace sage
             // std::cout << std::format(
             // "Entity {}: Requested destination is outside of pathfinding range \n", static_cast<int>(entity));
             moveable.onDestinationUnreachable.Publish(entity, destination);
-            return;
+            return false;
         }
 
-        const auto& collideable = registry->get<Collideable>(entity);
-        sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, false);
+        return true;
+    }
 
+    // Short moves are searched straight away, so they start this frame. Longer ones go to the worker threads, and
+    // start once their result is applied (see RequestPathfindToLocation).
+    void ActorMovementSystem::PathfindToLocation(
+        const entt::entity& entity, const Vector3& destination, bool astar) const
+    {
         const auto& actorTrans = registry->get<sgTransform>(entity);
+        GridSquare start{};
+        GridSquare finish{};
+        if (!sys->navigationGridSystem->WorldToGridSpace(actorTrans.GetWorldPos(), start) ||
+            !sys->navigationGridSystem->WorldToGridSpace(destination, finish) ||
+            std::max(std::abs(start.row - finish.row), std::abs(start.col - finish.col)) >
+                IMMEDIATE_PATHFIND_SQUARES)
+        {
+            RequestPathfindToLocation(entity, destination, astar);
+            return;
+        }
+
+        GridSquare minRange{};
+        GridSquare maxRange{};
+        if (!validateDestination(entity, destination, astar, minRange, maxRange)) return;
+        // Supersedes anything still being searched for
+        pathfindingJobs->Cancel(entity);
+
+        // The actor must not block its own search
+        sys->navigationGridSystem->RemoveDynamicOccupant(entity);
+
         //        const auto path =
         //            navigationGridSystem->AStarPathfind(entity, actorTrans.GetWorldPos(), destination, minRange,
         //            maxRange);
 
-        const auto path = astar ? sys->navigationGridSystem->AStarPathfind(
-                                      entity, actorTrans.GetWorldPos(), destination, minRange, maxRange)
+        const auto path = astar ? sys->navigationGridSystem->HierarchicalPathfind(
+                                      entity, actorTrans.GetWorldPos(), destination)
                                 : sys->navigationGridSystem->BFSPathfind(
                                       entity, actorTrans.GetWorldPos(), destination, minRange, maxRange);
 
+        startPath(entity, path, destination);
+
+        const auto& collideable = registry->get<Collideable>(entity);
+        sys->navigationGridSystem->PlaceDynamicOccupant(entity, collideable.worldBoundingBox);
+    }
+
+    // Falls back to PathfindToLocation if the actor is outside the target's field
+    void ActorMovementSystem::PathfindToTarget(const entt::entity& entity, const entt::entity& target) const
+    {
+        const auto& targetPos = registry->get<sgTransform>(target).GetWorldPos();
+        Vector3 next{};
+        if (!nextFlowFieldStep(entity, target, next))
+        {
+            RequestPathfindToLocation(entity, targetPos);
+            return;
+        }
+
+        startPath(entity, {next}, targetPos);
+        registry->get<MoveableActor>(entity).flowFieldTarget = target;
+    }
+
+    bool ActorMovementSystem::nextFlowFieldStep(
+        const entt::entity entity, const entt::entity target, Vector3& next) const
+    {
+        // The actor must not block its own step
+        sys->navigationGridSystem->RemoveDynamicOccupant(entity);
+        const auto& actorTrans = registry->get<sgTransform>(entity);
+        const bool found =
+            sys->navigationGridSystem->FlowFieldNextStep(entity, actorTrans.GetWorldPos(), target, next);
+        const auto& collideable = registry->get<Collideable>(entity);
+        sys->navigationGridSystem->PlaceDynamicOccupant(entity, collideable.worldBoundingBox);
+        return found;
+    }
+
+    // Plans the next steps against the rest of the actor's movementGroup (see CooperativePlanner), and keeps out
+    // of the way of "followed" (e.g., the party leader, or the wave's target). A member replans at most once per
+    // CooperativePlanner::WINDOW steps while the table holds.
+    void ActorMovementSystem::PathfindToLocationInGroup(
+        const entt::entity& entity, const Vector3& destination, const entt::entity& followed) const
+    {
+        const auto& moveable = registry->get<MoveableActor>(entity);
+        const auto group = moveable.movementGroup;
+        if (group == entt::null)
+        {
+            PathfindToLocation(entity, destination, true);
+            return;
+        }
+
+        GridSquare minRange{};
+        GridSquare maxRange{};
+        if (!validateDestination(entity, destination, true, minRange, maxRange)) return;
+
+        auto& cooperativeGroup = cooperativeGroups[group];
+        const auto& followedMoveable = registry->get<MoveableActor>(followed);
+        const auto& followedTransform = registry->get<sgTransform>(followed);
+        const auto targetDestination =
+            followedMoveable.IsMoving() ? followedMoveable.GetDestination() : followedTransform.GetWorldPos();
+
+        // The table starts again once the followed entity heads somewhere else, or it runs out of steps
+        const int stepFrames = framesPerStep(moveable);
+        int step = static_cast<int>(frame - cooperativeGroup.originFrame) / stepFrames;
+        if (cooperativeGroup.round == 0 || step > CooperativePlanner::LAST_START_STEP ||
+            followed != cooperativeGroup.followed ||
+            (frame != cooperativeGroup.originFrame &&
+             !Vector3Equals(targetDestination, cooperativeGroup.targetDestination)))
+        {
+            cooperativeGroup.planner.Reset();
+            ++cooperativeGroup.round;
+            cooperativeGroup.originFrame = frame;
+            cooperativeGroup.followed = followed;
+            cooperativeGroup.targetDestination = targetDestination;
+            step = 0;
+            sys->navigationGridSystem->ReserveRoute(
+                followed, cooperativeGroup.planner, followedTransform.GetWorldPos(), followedMoveable.path, 0);
+        }
+        else if (const auto member = cooperativeMembers.find(entity);
+                 member != cooperativeMembers.end() && member->second.group == group &&
+                 member->second.round == cooperativeGroup.round &&
+                 frame - member->second.plannedFrame < CooperativePlanner::WINDOW * stepFrames)
+        {
+            // The current plan still holds for the rest of its window
+            return;
+        }
+
+        // Leaving could erase the group while it is in use, so a member of this group only drops its reservations
+        if (const auto member = cooperativeMembers.find(entity);
+            member != cooperativeMembers.end() && member->second.group == group)
+        {
+            cooperativeGroup.planner.Release(entity);
+        }
+        else
+        {
+            leaveCooperativeGroup(entity);
+        }
+
+        std::vector<entt::entity> reserved{entity, followed};
+        for (const auto& [member, membership] : cooperativeMembers)
+        {
+            if (member != followed && membership.group == group && membership.round == cooperativeGroup.round)
+            {
+                reserved.push_back(member);
+            }
+        }
+        for (const auto& other : reserved)
+        {
+            sys->navigationGridSystem->RemoveDynamicOccupant(other);
+        }
+
+        const auto& actorTrans = registry->get<sgTransform>(entity);
+        const auto path = sys->navigationGridSystem->CooperativePathfind(
+            entity, cooperativeGroup.planner, actorTrans.GetWorldPos(), destination, step);
+        startPath(entity, path, destination);
+        if (!path.empty())
+        {
+            const CooperativeMember member{group, cooperativeGroup.round, frame};
+            if (cooperativeMembers.insert_or_assign(entity, member).second) ++cooperativeGroup.members;
+        }
+
+        for (const auto& other : reserved)
+        {
+            if (!registry->any_of<Collideable>(other)) continue;
+            const auto& collideable = registry->get<Collideable>(other);
+            sys->navigationGridSystem->PlaceDynamicOccupant(other, collideable.worldBoundingBox);
+        }
+
+        if (path.empty())
+        {
+            leaveCooperativeGroup(entity);
+            // Also covers a group created by this call that nobody joined
+            const auto it = cooperativeGroups.find(group);
+            if (it != cooperativeGroups.end() && it->second.members == 0) cooperativeGroups.erase(it);
+        }
+    }
+
+    // The result is applied during a later Update. Returns NULL_PATHFIND_TICKET if rejected straight away.
+    PathfindTicket ActorMovementSystem::RequestPathfindToLocation(
+        const entt::entity& entity, const Vector3& destination, bool astar) const
+    {
+        GridSquare minRange{};
+        GridSquare maxRange{};
+        if (!validateDestination(entity, destination, astar, minRange, maxRange)) return NULL_PATHFIND_TICKET;
+
+        if (astar)
+        {
+            minRange = {0, 0};
+            maxRange = {sys->navigationGridSystem->slices, sys->navigationGridSystem->slices};
+        }
+
+        PathfindJob job{};
+        const auto& actorTrans = registry->get<sgTransform>(entity);
+        if (!sys->navigationGridSystem->PreparePathfindJob(
+                entity, actorTrans.GetWorldPos(), destination, minRange, maxRange, astar, job))
+        {
+            registry->get<MoveableActor>(entity).onDestinationUnreachable.Publish(entity, destination);
+            return NULL_PATHFIND_TICKET;
+        }
+        job.entity = entity;
+        job.destination = destination;
+
+        return pathfindingJobs->Submit(job);
+    }
+
+    bool ActorMovementSystem::IsPathfindPending(const entt::entity& entity) const
+    {
+        return pathfindingJobs->IsPending(entity);
+    }
+
+    void ActorMovementSystem::applyPathfindResults() const
+    {
+        pathfindingJobs->Collect([this](const PathfindResult& result) {
+            if (!registry->valid(result.entity) || !registry->all_of<MoveableActor>(result.entity)) return;
+            startPath(result.entity, result.path, result.destination);
+        });
+    }
+
+    void ActorMovementSystem::startPath(
+        const entt::entity& entity, const std::vector<Vector3>& path, const Vector3& destination) const
+    {
+        auto& moveable = registry->get<MoveableActor>(entity);
+        leaveCooperativeGroup(entity);
+
         if (moveable.IsMoving()) // Was previously moving
         {
             PruneMoveCommands(entity);
             moveable.onPathChanged.Publish(entity);
         }
 
-        for (auto n : path)
+        auto& transform = registry->get<sgTransform>(entity);
+
+        if (moveable.pathCurveSpacing > 0)
         {
-            moveable.path.emplace_back(n);
+            for (auto n : sys->navigationGridSystem->CurvePath(
+                     entity, transform.GetWorldPos(), path, moveable.pathCurveSpacing))
+            {
+                moveable.path.emplace_back(n);
+            }
+        }
+        else
+        {
+            for (auto n : path)
+            {
+                moveable.path.emplace_back(n);
+            }
         }
-
-        auto& transform = registry->get<sgTransform>(entity);
 
         if (!path.empty())
         {
@@ -144,8 +374,39 @@ namespace sage
             // std::cout << std::format(// "Entity {}: Destination unreachable \n", static_cast<int>(entity));
             moveable.onDestinationUnreachable.Publish(entity, destination);
         }
+    }
+
+    // Frames an actor takes to cross a square
+    int ActorMovementSystem::framesPerStep(const MoveableActor& moveableActor) const
+    {
+        return std::max(
+            1, static_cast<int>(std::ceil(sys->navigationGridSystem->spacing / moveableActor.movementSpeed)));
+    }
+
+    void ActorMovementSystem::leaveCooperativeGroup(const entt::entity entity) const
+    {
+        const auto member = cooperativeMembers.find(entity);
+        if (member == cooperativeMembers.end()) return;
+        if (const auto group = cooperativeGroups.find(member->second.group); group != cooperativeGroups.end())
+        {
+            group->second.planner.Release(entity);
+            if (--group->second.members == 0) cooperativeGroups.erase(group);
+        }
+        cooperativeMembers.erase(member);
+    }
 
-        sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, true, entity);
+    // Whether both actors' current movements were planned in the same reservation table
+    bool ActorMovementSystem::movesWithGroup(const entt::entity entity, const entt::entity other) const
+    {
+        const auto member = cooperativeMembers.find(entity);
+        if (member == cooperativeMembers.end()) return false;
+        const auto group = member->second.group;
+        const auto round = member->second.round;
+        const auto it = cooperativeGroups.find(group);
+        if (it == cooperativeGroups.end() || it->second.round != round) return false;
+        const auto otherMember = cooperativeMembers.find(other);
+        return otherMember != cooperativeMembers.end() && otherMember->second.group == group &&
+               otherMember->second.round == round;
     }
 
     bool ActorMovementSystem::ReachedDestination(entt::entity entity) const
@@ -185,16 +446,69 @@ namespace sage
     }
 
     bool ActorMovementSystem::isNextPointOccupied(
-        const MoveableActor& moveableActor, const Collideable& collideable) const
+        const entt::entity entity, const MoveableActor& moveableActor, const Collideable& collideable) const
     {
         return !sys->navigationGridSystem->CheckBoundingBoxAreaUnoccupied(
-            moveableActor.path.front(), collideable.worldBoundingBox);
+            moveableActor.path.front(), collideable.worldBoundingBox, entity);
     }
 
+    // Repairs the route with the actor's IncrementalPlanner within range, else searches on a worker thread
     void ActorMovementSystem::recalculatePath(
         const entt::entity entity, const MoveableActor& moveableActor, const Collideable& collideable) const
     {
-        PathfindToLocation(entity, moveableActor.GetDestination());
+        // Flow fields ignore moving actors, so anyone in the way is routed around on an ordinary path
+        const auto destination = registry->valid(moveableActor.flowFieldTarget)
+                                     ? registry->get<sgTransform>(moveableActor.flowFieldTarget).GetWorldPos()
+                                     : moveableActor.GetDestination();
+        GridSquare minRange{};
+        GridSquare maxRange{};
+        if (!sys->navigationGridSystem->GetPathfindRange(
+                entity, moveableActor.pathfindingBounds, minRange, maxRange) ||
+            !sys->navigationGridSystem->CheckWithinBounds(destination, minRange, maxRange))
+        {
+            // Keep waiting on the previous request rather than superseding it every frame
+            if (pathfindingJobs->IsPending(entity)) return;
+            RequestPathfindToLocation(entity, destination);
+            return;
+        }
+
+        pathfindingJobs->Cancel(entity);
+        sys->navigationGridSystem->RemoveDynamicOccupant(entity);
+        const auto& actorTrans = registry->get<sgTransform>(entity);
+        const auto path = sys->navigationGridSystem->IncrementalPathfind(
+            entity, usePlanner(entity), actorTrans.GetWorldPos(), destination, minRange, maxRange);
+        startPath(entity, path, destination);
+        sys->navigationGridSystem->PlaceDynamicOccupant(entity, collideable.worldBoundingBox);
+    }
+
+    // Evicts the least recently used planner if there are too many
+    IncrementalPlanner& ActorMovementSystem::usePlanner(const entt::entity entity) const
+    {
+        constexpr size_t maxPlanners = 64;
+
+        if (const auto it = plannerLookup.find(entity); it != plannerLookup.end())
+        {
+            planners.splice(planners.begin(), planners, it->second);
+            return it->second->second;
+        }
+
+        if (planners.size() >= maxPlanners)
+        {
+            plannerLookup.erase(planners.back().first);
+            planners.pop_back();
+        }
+        planners.emplace_front(entity, IncrementalPlanner{});
+        plannerLookup[entity] = planners.begin();
+        return planners.front().second;
+    }
+
+    void ActorMovementSystem::erasePlanner(const entt::entity entity) const
+    {
+        if (const auto it = plannerLookup.find(entity); it != plannerLookup.end())
+        {
+            planners.erase(it->second);
+            plannerLookup.erase(it);
+        }
     }
 
     bool ActorMovementSystem::hasReachedNextPoint(const sgTransform& transform, const MoveableActor& moveableActor)
@@ -208,11 +522,36 @@ namespace sage
     void ActorMovementSystem::handlePointReached(
         entt::entity entity, sgTransform& transform, MoveableActor& moveableActor) const
     {
-        setPositionToGridCenter(transform, moveableActor);
+        // Curved paths do not sit on the grid
+        if (moveableActor.pathCurveSpacing <= 0)
+        {
+            setPositionToGridCenter(transform, moveableActor);
+        }
+        const auto reached = moveableActor.path.front();
         moveableActor.path.pop_front();
 
+        // Cooperative paths repeat a waypoint for each step spent waiting on it (see CooperativePathfind)
+        while (!moveableActor.path.empty() && Vector3Equals(moveableActor.path.front(), reached))
+        {
+            moveableActor.path.pop_front();
+            moveableActor.waitFrames += framesPerStep(moveableActor);
+        }
+
+        if (moveableActor.path.empty() && moveableActor.flowFieldTarget != entt::null)
+        {
+            if (Vector3 next{}; registry->valid(moveableActor.flowFieldTarget) &&
+                                nextFlowFieldStep(entity, moveableActor.flowFieldTarget, next))
+            {
+                moveableActor.path.push_back(next);
+                return;
+            }
+            moveableActor.flowFieldTarget = entt::null;
+        }
+
         if (moveableActor.path.empty())
         {
+            pathfindingJobs->Cancel(entity); // A late result would only send the actor back to where it is
+            erasePlanner(entity);
             handleDestinationReached(entity, moveableActor);
         }
     }
@@ -223,8 +562,10 @@ namespace sage
         // Set continuous pos to grid/discrete pos
         GridSquare targetGridPos{};
         sys->navigationGridSystem->WorldToGridSpace(moveableActor.path.front(), targetGridPos);
-        const auto square = sys->navigationGridSystem->GetGridSquare(targetGridPos.row, targetGridPos.col);
-        transform.SetPosition({square->worldPosMin.x, square->GetTerrainHeight(), square->worldPosMin.z});
+        Vector3 worldPos{};
+        sys->navigationGridSystem->GridToWorldSpace(targetGridPos, worldPos);
+        transform.SetPosition(
+            {worldPos.x, sys->navigationGridSystem->GetTerrainHeight(targetGridPos), worldPos.z});
     }
 
     void ActorMovementSystem::handleDestinationReached(
@@ -242,13 +583,16 @@ namespace sage
 
         // navigationGridSystem->MarkSquaresDebug(moveableActor.debugRay, PURPLE, false);
 
-        NavigationGridSquare* hitCell =
-            castCollisionRay(actorIndex, transform.direction, avoidanceDistance, moveableActor);
+        const entt::entity hitOccupant =
+            castCollisionRay(entity, actorIndex, transform.direction, avoidanceDistance, moveableActor);
 
         // If we haven't hit anything, or the object is static, then we don't need to worry about it.
-        if (hitCell == nullptr || !registry->any_of<MoveableActor>(hitCell->occupant)) return false;
+        if (hitOccupant == entt::null || !registry->any_of<MoveableActor>(hitOccupant)) return false;
 
-        const auto& hitTransform = registry->get<sgTransform>(hitCell->occupant);
+        // Already planned around each other
+        if (movesWithGroup(entity, hitOccupant)) return false;
+
+        const auto& hitTransform = registry->get<sgTransform>(hitOccupant);
 
         // Going same direction, ignore.
         auto dot = Vector3DotProduct(transform.direction, hitTransform.direction);
@@ -257,24 +601,23 @@ namespace sage
             return false;
         }
 
-        if (registry->any_of<Collideable>(hitCell->occupant) &&
-            (!moveableActor.followTarget.has_value() ||
-             hitCell->occupant != moveableActor.followTarget->targetActor) &&
+        if (registry->any_of<Collideable>(hitOccupant) &&
+            (!moveableActor.followTarget.has_value() || hitOccupant != moveableActor.followTarget->targetActor) &&
             moveableActor.hitEntityId != entity)
         {
             if (!AlmostEquals(hitTransform.GetWorldPos(), moveableActor.hitLastPos))
             {
-                moveableActor.hitEntityId = hitCell->occupant;
+                moveableActor.hitEntityId = hitOccupant;
                 moveableActor.hitLastPos = hitTransform.GetWorldPos();
 
-                auto& hitCol = registry->get<Collideable>(hitCell->occupant);
+                auto& hitCol = registry->get<Collideable>(hitOccupant);
 
                 if (Vector3Distance(hitTransform.GetWorldPos(), transform.GetWorldPos()) <
                     Vector3Distance(moveableActor.path.back(), transform.GetWorldPos()))
                 {
                     // std::cout << std::format(
                     // "Entity {}: Collided with a moving object, rerouting \n", static_cast<int>(entity));
-                    PathfindToLocation(entity, moveableActor.GetDestination());
+                    recalculatePath(entity, moveableActor, registry->get<Collideable>(entity));
                     hitCol.debugDraw = true;
                     return true;
                 }
@@ -283,11 +626,21 @@ namespace sage
         return false;
     }
 
-    NavigationGridSquare* ActorMovementSystem::castCollisionRay(
-        const GridSquare& actorIndex, const Vector3& direction, float distance, MoveableActor& moveableActor) const
+    entt::entity ActorMovementSystem::castCollisionRay(
+        const entt::entity entity,
+        const GridSquare& actorIndex,
+        const Vector3& direction,
+        float distance,
+        MoveableActor& moveableActor) const
     {
+        if (!moveableActor.debugRayEnabled)
+        {
+            return sys->navigationGridSystem->CastRay(
+                actorIndex.row, actorIndex.col, {direction.x, direction.z}, distance, entity);
+        }
+        moveableActor.debugRay.clear();
         return sys->navigationGridSystem->CastRay(
-            actorIndex.row, actorIndex.col, {direction.x, direction.z}, distance, moveableActor.debugRay);
+            actorIndex.row, actorIndex.col, {direction.x, direction.z}, distance, entity, &moveableActor.debugRay);
     }
 
     void ActorMovementSystem::updateActorDirection(sgTransform& transform, const MoveableActor& moveableActor)
@@ -308,11 +661,10 @@ namespace sage
     {
         GridSquare actorIndex{};
         sys->navigationGridSystem->WorldToGridSpace(transform.GetWorldPos(), actorIndex);
-        auto gridSquare = sys->navigationGridSystem->GetGridSquare(actorIndex.row, actorIndex.col);
         auto& moveable = registry->get<MoveableActor>(entity);
         Vector3 newPos = {
             transform.GetWorldPos().x + transform.direction.x * moveable.movementSpeed,
-            gridSquare->GetTerrainHeight(),
+            sys->navigationGridSystem->GetTerrainHeight(actorIndex),
             transform.GetWorldPos().z + transform.direction.z * moveable.movementSpeed};
 
         transform.SetPosition(newPos);
@@ -334,13 +686,40 @@ namespace sage
             return;
         }
 
-        if (isNextPointOccupied(moveableActor, collideable))
+        if (moveableActor.waitFrames > 0)
+        {
+            --moveableActor.waitFrames;
+            return;
+        }
+
+        if (isNextPointOccupied(entity, moveableActor, collideable))
         {
             // std::cout << std::format(// "Entity {}: Next point occupied, rerouting \n",
             // static_cast<int>(entity));
-            recalculatePath(entity, moveableActor, collideable);
+            const auto member = cooperativeMembers.find(entity);
+            if (member == cooperativeMembers.end())
+            {
+                recalculatePath(entity, moveableActor, collideable);
+                return;
+            }
+            // Whoever is in the way was probably planned around, so give them a couple of steps
+            if (++moveableActor.blockedFrames > framesPerStep(moveableActor) * 2)
+            {
+                moveableActor.blockedFrames = 0;
+                const auto followed = cooperativeGroups.at(member->second.group).followed;
+                leaveCooperativeGroup(entity);
+                if (followed != entt::null && registry->valid(followed))
+                {
+                    PathfindToLocationInGroup(entity, moveableActor.GetDestination(), followed);
+                }
+                else
+                {
+                    PathfindToLocation(entity, moveableActor.GetDestination(), true);
+                }
+            }
             return;
         }
+        moveableActor.blockedFrames = 0;
 
         if (hasReachedNextPoint(transform, moveableActor))
         {
@@ -363,6 +742,12 @@ namespace sage
             return;
         }
 
+        if (moveableActor.waitFrames > 0)
+        {
+            --moveableActor.waitFrames;
+            return;
+        }
+
         if (hasReachedNextPoint(transform, moveableActor))
         {
             handlePointReached(entity, transform, moveableActor);
@@ -374,14 +759,16 @@ namespace sage
 
     void ActorMovementSystem::Update()
     {
+        ++frame;
         clearDebugData();
+        applyPathfindResults();
 
+        // Applied together, once everyone has moved
         auto fullView = registry->view<MoveableActor, sgTransform, Collideable>();
         for (auto [entity, moveableActor, transform, collideable] : fullView.each())
         {
-            sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, false);
             updateActor(entity, moveableActor, transform, collideable);
-            sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, true);
+            sys->navigationGridSystem->QueueDynamicOccupant(entity, collideable.worldBoundingBox);
         }
 
         // Process entities without Collideable component (e.g., some abilities etc)
@@ -390,11 +777,44 @@ namespace sage
         {
             updateActor(entity, moveableActor, transform);
         }
+
+        sys->navigationGridSystem->FlushDynamicOccupants();
+
+        if (pathfindingJobs->HasUndispatchedJobs())
+        {
+            pathfindingJobs->Dispatch();
+        }
+    }
+
+    // Anything that starts moving leaves the static layer
+    void ActorMovementSystem::onComponentAdded(const entt::entity entity)
+    {
+        if (!registry->any_of<Collideable>(entity)) return;
+        const auto& collideable = registry->get<Collideable>(entity);
+        sys->navigationGridSystem->RemoveStaticOccupant(entity, collideable.worldBoundingBox);
+    }
+
+    void ActorMovementSystem::onComponentRemoved(const entt::entity entity)
+    {
+        pathfindingJobs->Cancel(entity);
+        erasePlanner(entity);
+        leaveCooperativeGroup(entity);
+        // Groups following the entity are disbanded. Their members keep their current paths.
+        std::erase_if(cooperativeGroups, [entity](const auto& group) { return group.second.followed == entity; });
+        std::erase_if(cooperativeMembers, [this](const auto& member) {
+            return !cooperativeGroups.contains(member.second.group);
+        });
+        sys->navigationGridSystem->RemoveDynamicOccupant(entity);
     }
 
     ActorMovementSystem::ActorMovementSystem(entt::registry* _registry, Systems* _sys)
-        : BaseSystem(_registry), sys(_sys)
+        : BaseSystem(_registry),
+          sys(_sys),
+          pathfindingJobs(std::make_unique<PathfindingJobQueue>(
+              sys->navigationGridSystem.get(), std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1))
     {
+        registry->on_construct<MoveableActor>().connect<&ActorMovementSystem::onComponentAdded>(this);
+        registry->on_destroy<MoveableActor>().connect<&ActorMovementSystem::onComponentRemoved>(this);
     }
 } // namespace sage
 
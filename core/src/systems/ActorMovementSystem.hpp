@@ -4,8 +4,14 @@
 #pragma once
 
 #include "BaseSystem.hpp"
+#include "navigation/CooperativePlanner.hpp"
+#include "navigation/IncrementalPlanner.hpp"
+#include "navigation/PathfindingJobQueue.hpp"
 #include "raylib.h"
 
+#include <list>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace sage
@@ -16,15 +22,49 @@ namespace sage
     class Collideable;
     struct sgTransform;
     struct GridSquare;
-    struct NavigationGridSquare;
 
     class ActorMovementSystem : public BaseSystem
     {
         Systems* sys;
+        std::unique_ptr<PathfindingJobQueue> pathfindingJobs;
+        // Most recently used first
+        using PlannerList = std::list<std::pair<entt::entity, IncrementalPlanner>>;
+        mutable PlannerList planners;
+        mutable std::unordered_map<entt::entity, PlannerList::iterator> plannerLookup;
+
+        struct CooperativeGroup
+        {
+            CooperativePlanner planner;
+            unsigned round = 0; // Incremented whenever the planner is Reset
+            unsigned originFrame = 0;
+            entt::entity followed = entt::null;
+            Vector3 targetDestination{};
+            int members = 0; // Entries in cooperativeMembers. The group is erased when the last one leaves.
+        };
+        struct CooperativeMember
+        {
+            entt::entity group;
+            unsigned round; // Only holds reservations in its group's planner if this is the group's round
+            unsigned plannedFrame;
+        };
+        // Reservation tables of actors moving together, by MoveableActor::movementGroup
+        mutable std::unordered_map<entt::entity, CooperativeGroup> cooperativeGroups;
+        mutable std::unordered_map<entt::entity, CooperativeMember> cooperativeMembers;
+        unsigned frame = 0;
+
         std::vector<Ray> debugRays;
         std::vector<RayCollision> debugCollisions;
 
         void clearDebugData();
+        void onComponentAdded(entt::entity entity);
+        void onComponentRemoved(entt::entity entity);
+        void applyPathfindResults() const;
+        [[nodiscard]] bool validateDestination(
+            const entt::entity& entity,
+            const Vector3& destination,
+            bool astar,
+            GridSquare& minRange,
+            GridSquare& maxRange) const;
         void updateActor(
             entt::entity entity,
             MoveableActor& moveableActor,
@@ -32,14 +72,15 @@ namespace sage
             Collideable& collideable) const;
         void updateActor(entt::entity entity, MoveableActor& moveableActor, sgTransform& transform) const;
         [[nodiscard]] bool isNextPointOccupied(
-            const MoveableActor& moveableActor, const Collideable& collideable) const;
+            entt::entity entity, const MoveableActor& moveableActor, const Collideable& collideable) const;
         void recalculatePath(
             entt::entity entity, const MoveableActor& moveableActor, const Collideable& collideable) const;
         static bool hasReachedNextPoint(const sgTransform& transform, const MoveableActor& moveableActor);
         void handlePointReached(entt::entity entity, sgTransform& transform, MoveableActor& moveableActor) const;
         void setPositionToGridCenter(sgTransform& transform, const MoveableActor& moveableActor) const;
         static void handleDestinationReached(entt::entity entity, const MoveableActor& moveableActor);
-        NavigationGridSquare* castCollisionRay(
+        entt::entity castCollisionRay(
+            entt::entity entity,
             const GridSquare& actorIndex,
             const Vector3& direction,
             float distance,
@@ -48,6 +89,14 @@ namespace sage
         static void updateActorDirection(sgTransform& transform, const MoveableActor& moveableActor);
         static void updateActorRotation(entt::entity entity, sgTransform& transform);
         void updateActorWorldPosition(entt::entity entity, sgTransform& transform) const;
+        void startPath(
+            const entt::entity& entity, const std::vector<Vector3>& path, const Vector3& destination) const;
+        IncrementalPlanner& usePlanner(entt::entity entity) const;
+        void erasePlanner(entt::entity entity) const;
+        [[nodiscard]] bool nextFlowFieldStep(entt::entity entity, entt::entity target, Vector3& next) const;
+        [[nodiscard]] int framesPerStep(const MoveableActor& moveableActor) const;
+        void leaveCooperativeGroup(entt::entity entity) const;
+        [[nodiscard]] bool movesWithGroup(entt::entity entity, entt::entity other) const;
 
       public:
         [[nodiscard]] bool CheckCollisionWithOtherMoveable(
@@ -56,7 +105,16 @@ namespace sage
         void PruneMoveCommands(const entt::entity& entity) const;
         [[nodiscard]] bool TryPathfindToLocation(
             const entt::entity& entity, const Vector3& destination, bool astar = false) const;
+        // Moves no further than this (in squares, either way) are searched on the main thread
+        static constexpr int IMMEDIATE_PATHFIND_SQUARES = 8;
+
         void PathfindToLocation(const entt::entity& entity, const Vector3& destination, bool astar = false) const;
+        void PathfindToTarget(const entt::entity& entity, const entt::entity& target) const;
+        void PathfindToLocationInGroup(
+            const entt::entity& entity, const Vector3& destination, const entt::entity& followed) const;
+        PathfindTicket RequestPathfindToLocation(
+            const entt::entity& entity, const Vector3& destination, bool astar = false) const;
+        [[nodiscard]] bool IsPathfindPending(const entt::entity& entity) const;
         void MoveToLocation(const entt::entity& entity, Vector3 location) const;
         void CancelMovement(const entt::entity& entity) const;
         void Update() override;
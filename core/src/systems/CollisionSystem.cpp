@@ -8,9 +8,18 @@
 #include <Serializer.hpp>
 
 #include <algorithm>
+#include <limits>
 
 namespace sage
 {
+    namespace
+    {
+        // Layers that a ray hits the mesh of, rather than the bounding box (see CollisionLayer)
+        bool usesMeshCollision(const CollisionLayer layer)
+        {
+            return layer == CollisionLayer::FLOORCOMPLEX || layer == CollisionLayer::STAIRS;
+        }
+    } // namespace
 
     void CollisionSystem::SortCollisionsByDistance(std::vector<CollisionInfo>& collisions)
     {
@@ -19,34 +28,104 @@ namespace sage
         });
     }
 
-    std::vector<CollisionInfo> CollisionSystem::GetCollisionsWithBoundingBox(
-        const BoundingBox& bb, CollisionLayer layer)
+    CollisionLayerMask CollisionSystem::collidesWith(const CollisionLayer layer) const
     {
-        std::vector<CollisionInfo> collisions;
+        CollisionLayerMask mask = 0;
+        const auto& row = collisionMatrix[static_cast<int>(layer)];
+        for (int other = 0; other < static_cast<int>(CollisionLayer::COUNT); ++other)
+        {
+            if (row[other]) mask |= LayerBit(static_cast<CollisionLayer>(other));
+        }
+        return mask;
+    }
 
-        auto view = registry->view<Collideable>();
+    void CollisionSystem::insertPending()
+    {
+        for (const auto entity : pending)
+        {
+            if (!registry->valid(entity) || !registry->any_of<Collideable>(entity)) continue;
+            if (staticBvh.Contains(entity) || dynamicTree.Contains(entity)) continue;
+            const auto& c = registry->get<Collideable>(entity);
+            dynamicTree.Insert({entity, c.worldBoundingBox, c.collisionLayer});
+        }
+        pending.clear();
+    }
+
+    void CollisionSystem::onComponentAdded(const entt::entity entity)
+    {
+        pending.push_back(entity);
+    }
+
+    void CollisionSystem::onComponentUpdated(const entt::entity entity)
+    {
+        if (!dynamicTree.Contains(entity)) return; // Still pending, or static
+        const auto& c = registry->get<Collideable>(entity);
+        dynamicTree.Move(entity, c.worldBoundingBox);
+        dynamicTree.SetLayer(entity, c.collisionLayer);
+    }
+
+    void CollisionSystem::onComponentRemoved(const entt::entity entity)
+    {
+        staticBvh.Remove(entity);
+        dynamicTree.Remove(entity);
+        std::erase(pending, entity);
+    }
 
-        view.each([&](auto entity, const auto& c) {
-            if (!c.active) return;
-            if (collisionMatrix[static_cast<int>(layer)][static_cast<int>(c.collisionLayer)])
+    void CollisionSystem::BuildStaticBvh()
+    {
+        std::vector<CollisionProxy> proxies;
+        pending.clear();
+        dynamicTree.Clear();
+        for (const auto entity : registry->view<Collideable>())
+        {
+            const auto& c = registry->get<Collideable>(entity);
+            if (c.IsDynamic())
             {
-                if (CheckCollisionBoxes(bb, c.worldBoundingBox))
-                {
-                    CollisionInfo info = {
-                        .collidedEntityId = entity,
-                        .collidedBB = c.worldBoundingBox,
-                        .rlCollision = {},
-                        .collisionLayer = c.collisionLayer};
-                    collisions.push_back(info);
-                }
+                dynamicTree.Insert({entity, c.worldBoundingBox, c.collisionLayer});
+                continue;
             }
-        });
+            proxies.push_back({entity, c.worldBoundingBox, c.collisionLayer});
+        }
+        staticBvh.Build(proxies);
+    }
 
-        SortCollisionsByDistance(collisions);
+    void CollisionSystem::UpdateCollideable(const entt::entity entity)
+    {
+        const auto& c = registry->get<Collideable>(entity);
+        if (staticBvh.Contains(entity))
+        {
+            staticBvh.Update(entity, c.worldBoundingBox, c.collisionLayer);
+        }
+        else if (dynamicTree.Contains(entity))
+        {
+            dynamicTree.Move(entity, c.worldBoundingBox);
+            dynamicTree.SetLayer(entity, c.collisionLayer);
+        }
+    }
 
+    std::vector<CollisionInfo> CollisionSystem::GetCollisionsWithBoundingBox(
+        const BoundingBox& bb, CollisionLayer layer)
+    {
+        std::vector<CollisionInfo> collisions;
+        ForEachCollisionWithBoundingBox(bb, layer, [&](const CollisionInfo& info) {
+            collisions.push_back(info);
+            return true;
+        });
         return collisions;
     }
 
+    size_t CollisionSystem::GetCollisionsWithBoundingBox(
+        const BoundingBox& bb, const std::span<CollisionInfo> out, const CollisionLayer layer)
+    {
+        size_t count = 0;
+        ForEachCollisionWithBoundingBox(bb, layer, [&](const CollisionInfo& info) {
+            if (count == out.size()) return false;
+            out[count++] = info;
+            return true;
+        });
+        return count;
+    }
+
     std::vector<CollisionInfo> CollisionSystem::GetCollisionsWithRay(const Ray& ray, CollisionLayer layer)
     {
         return GetCollisionsWithRay(entt::null, ray, layer);
@@ -56,24 +135,9 @@ namespace sage
         const entt::entity& caster, const Ray& ray, CollisionLayer layer)
     {
         std::vector<CollisionInfo> collisions;
-
-        const auto view = registry->view<Collideable>();
-
-        view.each([&](auto entity, const auto& c) {
-            if (!c.active || entity == caster) return;
-            if (collisionMatrix[static_cast<int>(layer)][static_cast<int>(c.collisionLayer)])
-            {
-                auto col = GetRayCollisionBox(ray, c.worldBoundingBox);
-                if (col.hit)
-                {
-                    CollisionInfo info = {
-                        .collidedEntityId = entity,
-                        .collidedBB = c.worldBoundingBox,
-                        .rlCollision = col,
-                        .collisionLayer = c.collisionLayer};
-                    collisions.push_back(info);
-                }
-            }
+        ForEachCollisionWithRay(caster, ray, layer, [&](const CollisionInfo& info) {
+            collisions.push_back(info);
+            return true;
         });
 
         SortCollisionsByDistance(collisions);
@@ -81,29 +145,119 @@ namespace sage
         return collisions;
     }
 
-    bool CollisionSystem::GetFirstCollisionWithRay(const Ray& ray, CollisionInfo& info, CollisionLayer layer)
+    size_t CollisionSystem::GetCollisionsWithRay(
+        const entt::entity& caster,
+        const Ray& _ray,
+        const std::span<CollisionInfo> out,
+        const CollisionLayer layer)
     {
-        auto view = registry->view<Collideable>();
+        if (out.empty()) return 0;
 
-        view.each([&](auto entity, const auto& c) {
-            if (!c.active) return false;
-            if (collisionMatrix[static_cast<int>(layer)][static_cast<int>(c.collisionLayer)])
+        // Normalised, so that the box distances can prune the trees' distances
+        const Ray ray{_ray.position, Vector3Normalize(_ray.direction)};
+        // While "out" fills up, the farthest hit kept so far is at the front of this max-heap
+        auto farther = [](const CollisionInfo& a, const CollisionInfo& b) {
+            return a.rlCollision.distance < b.rlCollision.distance;
+        };
+        size_t count = 0;
+        float maxDistance = std::numeric_limits<float>::max();
+
+        const auto layers = collidesWith(layer);
+        forEachNearRay(ray, layers, maxDistance, [&](const entt::entity entity, const Collideable& c) {
+            if (entity == caster) return true;
+            const auto col = GetRayCollisionBox(ray, c.worldBoundingBox);
+            if (!col.hit) return true;
+            if (count == out.size())
             {
-                auto col = GetRayCollisionBox(ray, c.worldBoundingBox);
-                if (col.hit)
-                {
-                    const CollisionInfo _info = {
-                        .collidedEntityId = entity,
-                        .collidedBB = c.worldBoundingBox,
-                        .rlCollision = col,
-                        .collisionLayer = c.collisionLayer};
-                    info = _info;
-                    return true;
-                }
+                if (col.distance >= out.front().rlCollision.distance) return true;
+                std::pop_heap(out.begin(), out.end(), farther);
+                --count;
             }
+
+            out[count++] = {
+                .collidedEntityId = entity,
+                .collidedBB = c.worldBoundingBox,
+                .rlCollision = col,
+                .collisionLayer = c.collisionLayer};
+            std::push_heap(out.begin(), out.begin() + count, farther);
+            // Once full, nothing farther than the farthest hit kept can make it in
+            if (count == out.size()) maxDistance = std::max(out.front().rlCollision.distance, 0.0f);
+            return true;
         });
 
-        return false;
+        std::sort_heap(out.begin(), out.begin() + count, farther);
+        return count;
+    }
+
+    bool CollisionSystem::getMeshCollision(const entt::entity entity, const Ray& ray, RayCollision& out) const
+    {
+        if (!registry->any_of<Renderable>(entity)) return false;
+        const auto& model = registry->get<Renderable>(entity).GetModel();
+        const auto transform = registry->get<sgTransform>(entity).GetMatrix();
+        bool found = false;
+        for (int i = 0; i < model->GetMeshCount(); ++i)
+        {
+            const auto col = model->GetRayMeshCollision(ray, i, transform);
+            if (col.hit && (!found || col.distance < out.distance))
+            {
+                out = col;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    bool CollisionSystem::GetFirstCollisionWithRay(const Ray& ray, CollisionInfo& info, const CollisionLayer layer)
+    {
+        return GetFirstCollisionWithRay(entt::null, ray, info, layer);
+    }
+
+    bool CollisionSystem::GetFirstCollisionWithRay(
+        const entt::entity& caster, const Ray& _ray, CollisionInfo& info, const CollisionLayer layer)
+    {
+        // Normalised, so that box and mesh distances can be compared with (and prune) the trees' distances
+        const Ray ray{_ray.position, Vector3Normalize(_ray.direction)};
+        bool found = false;
+        float maxDistance = std::numeric_limits<float>::max();
+
+        const auto layers = collidesWith(layer);
+        forEachNearRay(ray, layers, maxDistance, [&](const entt::entity entity, const Collideable& c) {
+            if (entity == caster) return true;
+            auto col = GetRayCollisionBox(ray, c.worldBoundingBox);
+            if (!col.hit) return true;
+            if (usesMeshCollision(c.collisionLayer) && !getMeshCollision(entity, ray, col)) return true;
+            if (found && col.distance >= info.rlCollision.distance) return true;
+
+            info = {
+                .collidedEntityId = entity,
+                .collidedBB = c.worldBoundingBox,
+                .rlCollision = col,
+                .collisionLayer = c.collisionLayer};
+            found = true;
+            // Boxes the ray starts in have a negative distance (and are entered at 0), so must still be visited
+            maxDistance = std::max(col.distance, 0.0f);
+            return true;
+        });
+
+        return found;
+    }
+
+    bool CollisionSystem::AnyCollisionWithRay(
+        const entt::entity& caster,
+        const Ray& ray,
+        float maxDistance,
+        const CollisionLayer layer,
+        const CollisionLayerMask ignoredLayers)
+    {
+        bool found = false;
+        // The trees only visit boxes that the ray enters within maxDistance
+        const auto layers = collidesWith(layer) & ~ignoredLayers;
+        forEachNearRay(ray, layers, maxDistance, [&](const entt::entity entity, const Collideable&) {
+            if (entity == caster) return true;
+            found = true;
+            return false;
+        });
+        return found;
     }
 
     std::vector<CollisionInfo> CollisionSystem::GetMeshCollisionsWithRay(
@@ -111,28 +265,25 @@ namespace sage
     {
         std::vector<CollisionInfo> collisions;
 
-        const auto view = registry->view<Collideable>();
-
-        view.each([&](auto entity, const auto& c) {
-            if (!c.active || entity == caster) return;
-            if (collisionMatrix[static_cast<int>(layer)][static_cast<int>(c.collisionLayer)])
+        // A mesh is only tested if the ray hits its bounding box
+        float maxDistance = std::numeric_limits<float>::max();
+        const auto layers = collidesWith(layer);
+        forEachNearRay(ray, layers, maxDistance, [&](const entt::entity entity, const Collideable& c) {
+            if (entity == caster || !registry->any_of<Renderable>(entity)) return true;
+            if (!GetRayCollisionBox(ray, c.worldBoundingBox).hit) return true;
+            auto& renderable = registry->get<Renderable>(entity);
+            auto& transform = registry->get<sgTransform>(entity);
+            auto col = renderable.GetModel()->GetRayMeshCollision(ray, 0, transform.GetMatrix());
+            if (col.hit)
             {
-                if (registry->any_of<Renderable>(entity))
-                {
-                    auto& renderable = registry->get<Renderable>(entity);
-                    auto& transform = registry->get<sgTransform>(entity);
-                    auto col = renderable.GetModel()->GetRayMeshCollision(ray, 0, transform.GetMatrix());
-                    if (col.hit)
-                    {
-                        CollisionInfo info = {
-                            .collidedEntityId = entity,
-                            .collidedBB = c.worldBoundingBox,
-                            .rlCollision = col,
-                            .collisionLayer = c.collisionLayer};
-                        collisions.push_back(info);
-                    }
-                }
+                CollisionInfo info = {
+                    .collidedEntityId = entity,
+                    .collidedBB = c.worldBoundingBox,
+                    .rlCollision = col,
+                    .collisionLayer = c.collisionLayer};
+                collisions.push_back(info);
             }
+            return true;
         });
 
         SortCollisionsByDistance(collisions);
@@ -196,29 +347,19 @@ namespace sage
     bool CollisionSystem::GetFirstCollisionBB(
         entt::entity caller, BoundingBox bb, CollisionLayer layer, CollisionInfo& out)
     {
-        auto view = registry->view<Collideable>();
-
-        for (const auto& entity : view)
-        {
-            if (caller == entity) continue;
-            const auto& col = view.get<Collideable>(entity);
-            if (!col.active) continue;
-            if (collisionMatrix[static_cast<int>(layer)][static_cast<int>(col.collisionLayer)])
-            {
-                bool colHit = CheckBoxCollision(bb, col.worldBoundingBox);
-                if (colHit)
-                {
-                    CollisionInfo colInfo = {
-                        .collidedEntityId = entity,
-                        .collidedBB = col.worldBoundingBox,
-                        .rlCollision = {},
-                        .collisionLayer = layer};
-                    out = colInfo;
-                    return true;
-                };
-            }
-        }
-        return false;
+        bool found = false;
+        forEachNearBox(bb, layer, [&](const entt::entity entity, const Collideable& col) {
+            if (caller == entity || !CheckBoxCollision(bb, col.worldBoundingBox)) return true;
+            CollisionInfo colInfo = {
+                .collidedEntityId = entity,
+                .collidedBB = col.worldBoundingBox,
+                .rlCollision = {},
+                .collisionLayer = layer};
+            out = colInfo;
+            found = true;
+            return false;
+        });
+        return found;
     }
 
     CollisionMatrix CollisionSystem::CreateCollisionMatrix()
@@ -286,5 +427,12 @@ namespace sage
     CollisionSystem::CollisionSystem(entt::registry* _registry) : BaseSystem(_registry)
     {
         collisionMatrix = CreateCollisionMatrix();
+        for (const auto entity : registry->view<Collideable>())
+        {
+            pending.push_back(entity);
+        }
+        registry->on_construct<Collideable>().connect<&CollisionSystem::onComponentAdded>(this);
+        registry->on_update<Collideable>().connect<&CollisionSystem::onComponentUpdated>(this);
+        registry->on_destroy<Collideable>().connect<&CollisionSystem::onComponentRemoved>(this);
     }
 } // namespace sage
@@ -5,11 +5,15 @@
 #pragma once
 
 #include "BaseSystem.hpp"
+#include "collision/DynamicAabbTree.hpp"
+#include "collision/StaticBvh.hpp"
 #include "components/Collideable.hpp"
 
 #include "entt/entt.hpp"
 #include "raylib.h"
 
+#include <limits>
+#include <span>
 #include <vector>
 
 namespace sage
@@ -18,20 +22,71 @@ namespace sage
 
     class CollisionSystem : public BaseSystem
     {
+        StaticBvh staticBvh;
+        // Dynamic collideables, and static ones created after the BVH was built
+        DynamicAabbTree dynamicTree;
+        // Inserted lazily, as their bounding box and layer are set after creation
+        std::vector<entt::entity> pending;
+
         [[nodiscard]] static CollisionMatrix CreateCollisionMatrix();
+        [[nodiscard]] CollisionLayerMask collidesWith(CollisionLayer layer) const;
+        // Stops if fn returns false
+        template <typename Fn>
+        void forEachNearBox(const BoundingBox& bb, CollisionLayer layer, Fn&& fn);
+        // Nearest first. fn may lower maxDistance to prune the rest of the query.
+        template <typename Fn>
+        void forEachNearRay(const Ray& ray, CollisionLayerMask layers, float& maxDistance, Fn&& fn);
+        // Nearest hit of the ray with any of the entity's meshes
+        bool getMeshCollision(entt::entity entity, const Ray& ray, RayCollision& out) const;
+        void insertPending();
+        void onComponentAdded(entt::entity entity);
+        void onComponentUpdated(entt::entity entity);
+        void onComponentRemoved(entt::entity entity);
 
       public:
         CollisionMatrix collisionMatrix;
 
+        // Call once the map has loaded
+        void BuildStaticBvh();
+        // Call after changing the layer of a collideable, or the bounding box of a static one
+        void UpdateCollideable(entt::entity entity);
+
+        // Allocation-free. The visitor returns false to stop the query.
+        template <typename Visitor>
+        void ForEachCollisionWithBoundingBox(const BoundingBox& bb, CollisionLayer layer, Visitor&& visitor);
+        template <typename Visitor>
+        void ForEachCollisionWithRay(
+            const entt::entity& caster, const Ray& ray, CollisionLayer layer, Visitor&& visitor);
+        // Returns how many collisions were written
+        size_t GetCollisionsWithBoundingBox(
+            const BoundingBox& bb, std::span<CollisionInfo> out, CollisionLayer layer = CollisionLayer::DEFAULT);
+        // The out.size() nearest bounding box hits, nearest first. Returns how many were written.
+        size_t GetCollisionsWithRay(
+            const entt::entity& caster,
+            const Ray& ray,
+            std::span<CollisionInfo> out,
+            CollisionLayer layer = CollisionLayer::DEFAULT);
+
         static void SortCollisionsByDistance(std::vector<CollisionInfo>& collisions);
         [[nodiscard]] std::vector<CollisionInfo> GetMeshCollisionsWithRay(
             const entt::entity& caster, const Ray& ray, CollisionLayer layer);
+        // Allocates; prefer the span or visitor variants above
         [[nodiscard]] std::vector<CollisionInfo> GetCollisionsWithRay(
             const entt::entity& caster, const Ray& ray, CollisionLayer layer = CollisionLayer::DEFAULT);
         [[nodiscard]] std::vector<CollisionInfo> GetCollisionsWithRay(
             const Ray& ray, CollisionLayer layer = CollisionLayer::DEFAULT);
-        [[nodiscard]] bool GetFirstCollisionWithRay(
+        // Layers that collide by mesh (FLOORCOMPLEX, STAIRS) are tested against the mesh once their box is hit
+        bool GetFirstCollisionWithRay(
+            const entt::entity& caster, const Ray& ray, CollisionInfo& info, CollisionLayer layer);
+        bool GetFirstCollisionWithRay(
             const Ray& ray, CollisionInfo& info, CollisionLayer layer = CollisionLayer::DEFAULT);
+        // For occlusion checks. Layers in "ignoredLayers" do not block the ray.
+        [[nodiscard]] bool AnyCollisionWithRay(
+            const entt::entity& caster,
+            const Ray& ray,
+            float maxDistance,
+            CollisionLayer layer,
+            CollisionLayerMask ignoredLayers = 0);
         [[nodiscard]] std::vector<CollisionInfo> GetCollisionsWithBoundingBox(
             const BoundingBox& bb, CollisionLayer layer = CollisionLayer::DEFAULT);
         void BoundingBoxDraw(entt::entity entityId, Color color = LIME) const;
@@ -41,4 +96,70 @@ namespace sage
         void Update() override;
         explicit CollisionSystem(entt::registry* _registry);
     };
+
+    template <typename Fn>
+    void CollisionSystem::forEachNearBox(const BoundingBox& bb, const CollisionLayer layer, Fn&& fn)
+    {
+        insertPending();
+        const CollisionLayerMask layers = collidesWith(layer);
+        bool stopped = false;
+        auto visit = [&](const CollisionProxy& proxy) {
+            const auto& c = registry->get<Collideable>(proxy.entity);
+            if (!c.active || !(LayerBit(c.collisionLayer) & layers)) return true;
+            stopped = !fn(proxy.entity, c);
+            return !stopped;
+        };
+        staticBvh.QueryBox(bb, layers, visit);
+        if (!stopped) dynamicTree.QueryBox(bb, layers, visit);
+    }
+
+    template <typename Fn>
+    void CollisionSystem::forEachNearRay(
+        const Ray& ray, const CollisionLayerMask layers, float& maxDistance, Fn&& fn)
+    {
+        insertPending();
+        bool stopped = false;
+        auto visit = [&](const CollisionProxy& proxy) {
+            const auto& c = registry->get<Collideable>(proxy.entity);
+            if (!c.active || !(LayerBit(c.collisionLayer) & layers)) return true;
+            stopped = !fn(proxy.entity, c);
+            return !stopped;
+        };
+        staticBvh.QueryRay(ray, layers, maxDistance, visit);
+        if (!stopped) dynamicTree.QueryRay(ray, layers, maxDistance, visit);
+    }
+
+    template <typename Visitor>
+    void CollisionSystem::ForEachCollisionWithBoundingBox(
+        const BoundingBox& bb, const CollisionLayer layer, Visitor&& visitor)
+    {
+        forEachNearBox(bb, layer, [&](const entt::entity entity, const Collideable& c) {
+            if (!CheckCollisionBoxes(bb, c.worldBoundingBox)) return true;
+            const CollisionInfo info{
+                .collidedEntityId = entity,
+                .collidedBB = c.worldBoundingBox,
+                .rlCollision = {},
+                .collisionLayer = c.collisionLayer};
+            return visitor(info);
+        });
+    }
+
+    template <typename Visitor>
+    void CollisionSystem::ForEachCollisionWithRay(
+        const entt::entity& caster, const Ray& ray, const CollisionLayer layer, Visitor&& visitor)
+    {
+        float maxDistance = std::numeric_limits<float>::max();
+        const auto layers = collidesWith(layer);
+        forEachNearRay(ray, layers, maxDistance, [&](const entt::entity entity, const Collideable& c) {
+            if (entity == caster) return true;
+            const auto col = GetRayCollisionBox(ray, c.worldBoundingBox);
+            if (!col.hit) return true;
+            const CollisionInfo info{
+                .collidedEntityId = entity,
+                .collidedBB = c.worldBoundingBox,
+                .rlCollision = col,
+                .collisionLayer = c.collisionLayer};
+            return visitor(info);
+        });
+    }
 } // namespace sage
@@ -9,6 +9,7 @@
 #include "components/Collideable.hpp"
 #include "components/DoorBehaviorComponent.hpp"
 #include "components/sgTransform.hpp"
+#include "systems/CollisionSystem.hpp"
 #include "systems/NavigationGridSystem.hpp"
 
 namespace sage
@@ -39,6 +40,7 @@ namespace sage
         {
             auto& col = registry->get<Collideable>(entity);
             col.collisionLayer = CollisionLayer::BACKGROUND;
+            sys->collisionSystem->UpdateCollideable(entity);
             sys->navigationGridSystem->MarkSquareAreaOccupied(col.worldBoundingBox, false);
             float targetRotation = (transform.forward().z > 0) ? door.openYRotation : -door.openYRotation;
             transform.SetLocalRot(Vector3{rotx, targetRotation, rotz});
@@ -50,6 +52,7 @@ namespace sage
             door.open = false;
             auto& col = registry->get<Collideable>(entity);
             col.collisionLayer = CollisionLayer::BUILDING;
+            sys->collisionSystem->UpdateCollideable(entity);
             sys->navigationGridSystem->MarkSquareAreaOccupied(col.worldBoundingBox, true);
         }
     }
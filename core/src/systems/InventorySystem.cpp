@@ -50,8 +50,7 @@ namespace sage
             return false;
         }
 
-        const auto& collideable = registry->get<Collideable>(actorId);
-        sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, false);
+        sys->navigationGridSystem->RemoveDynamicOccupant(actorId);
         if (sys->navigationGridSystem->AStarPathfind(actorId, playerPos, cursorPos).empty())
         {
             if (!hover)
@@ -63,7 +62,8 @@ namespace sage
         {
             lastWorldItemHovered.reachable = true;
         }
-        sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, true);
+        const auto& collideable = registry->get<Collideable>(actorId);
+        sys->navigationGridSystem->PlaceDynamicOccupant(actorId, collideable.worldBoundingBox);
 
         return lastWorldItemHovered.reachable;
     }
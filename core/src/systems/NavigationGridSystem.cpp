@@ -2,27 +2,48 @@
 
 #include "CollisionSystem.hpp"
 #include "components/ControllableActor.hpp"
+#include "components/MoveableActor.hpp"
 #include "components/NavigationGridSquare.hpp"
 #include "components/Renderable.hpp"
 #include "components/sgTransform.hpp"
+#include "navigation/PathfindingContext.hpp"
+#include "navigation/PathfindingJobQueue.hpp"
 #include <Serializer.hpp>
+#include <TriangleBvh.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
-#include <queue>
-
-Vector3 calculateGridsquareCentre(Vector3 min, Vector3 max)
-{
-    Vector3 size = {0};
-
-    size.x = fabsf(max.x - min.x);
-    size.y = fabsf(max.y - min.y);
-    size.z = fabsf(max.z - min.z);
-
-    return {min.x + size.x / 2.0f, min.y + size.y / 2.0f, min.z + size.z / 2.0f};
-}
+#include <numbers>
+#include <thread>
 
 namespace sage
 {
+    namespace
+    {
+        // Set while running a PathfindJob, so searches read its snapshot instead of the live grid
+        struct OccupancyView
+        {
+            const OccupancySnapshot* occupancy = nullptr;
+            GridSquare ignoreMin{};
+            GridSquare ignoreMax{};
+        };
+        thread_local OccupancyView occupancyView;
+
+        // Uniform Catmull-Rom spline between p1 (t = 0) and p2 (t = 1)
+        Vector3 catmullRom(
+            const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3, const float t)
+        {
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+            auto axis = [t, t2, t3](const float a, const float b, const float c, const float d) {
+                return 0.5f *
+                       (2 * b + (c - a) * t + (2 * a - 5 * b + 4 * c - d) * t2 + (3 * b - a - 3 * c + d) * t3);
+            };
+            return {axis(p0.x, p1.x, p2.x, p3.x), axis(p0.y, p1.y, p2.y, p3.y), axis(p0.z, p1.z, p2.z, p3.z)};
+        }
+    } // namespace
 
     inline double heuristic(GridSquare a, GridSquare b)
     {
@@ -75,68 +96,122 @@ namespace sage
         slices = _slices;
         spacing = _spacing;
 
-        int halfSlices = slices / 2;
-
-        gridSquares.clear();
-        gridSquares.resize(slices);
-        for (int i = 0; i < slices; ++i)
-        {
-            gridSquares[i].resize(slices);
-        }
-
-        for (int j = -halfSlices; j < halfSlices; j++)
-        {
-            for (int i = -halfSlices; i < halfSlices; i++)
-            {
-                Vector3 v1 = {static_cast<float>(i) * spacing, 0, static_cast<float>(j) * spacing};
-                Vector3 v3 = {static_cast<float>(i + 1) * spacing, 1.0f, static_cast<float>(j + 1) * spacing};
+        // Re-initialising resets every square
+        gridStaticOccupied.Init(slices, false);
+        gridStaticOccupant.Init(slices, entt::null);
+        gridDynamicCount.Init(slices, 0);
+        gridDynamicOccupant.Init(slices, entt::null);
+        gridOccupied.Init(slices, false);
+        occupancyBits.Init(slices);
+        dynamicFootprints.clear();
+        pendingOccupants.clear();
+        gridPathfindingCost.Init(slices, 1);
+        terrain.Init(slices);
+        gridDebug.Init(slices, {});
+        clearanceMap.Init(slices, gridOccupied);
+        staticClearanceMap.Init(slices, gridStaticOccupied);
+        connectivityMap.Init(slices);
+        nearestWalkableMap.Init(slices);
+        hierarchicalGrid.Init(slices);
+        pathCache.Init(slices);
+    }
 
-                GridSquare gridSquareIndex = {i + halfSlices, j + halfSlices};
-                gridSquares[j + halfSlices][i + halfSlices] = std::make_unique<NavigationGridSquare>(
-                    gridSquareIndex, v1, v3, calculateGridsquareCentre(v1, v3));
-            }
-        }
+    // World position of the top left corner of a grid square
+    Vector3 NavigationGridSystem::getWorldPosMin(const int row, const int col) const
+    {
+        const int halfSlices = slices / 2;
+        return {static_cast<float>(col - halfSlices) * spacing, 0, static_cast<float>(row - halfSlices) * spacing};
     }
 
     void NavigationGridSystem::DrawDebugPathfinding(const GridSquare& minRange, const GridSquare& maxRange) const
     {
         // return;
-        for (int i = 0; i < gridSquares.size(); i++)
-        {
-            for (int j = 0; j < gridSquares.at(0).size(); j++)
-            {
-                gridSquares[i][j]->drawDebug = false;
-            }
-        }
+        gridDebug.Clear();
         for (int i = minRange.row; i < maxRange.row; i++)
         {
             for (int j = minRange.col; j < maxRange.col; j++)
             {
-                gridSquares[i][j]->drawDebug = true;
+                setDrawDebug({i, j}, true);
             }
         }
     }
 
-    void NavigationGridSystem::MarkSquareAreaOccupiedIfSteep(const BoundingBox& occupant, bool occupied)
+    void NavigationGridSystem::setDrawDebug(const GridSquare square, const bool drawDebug) const
+    {
+        auto debug = gridDebug.Get(square);
+        debug.drawDebug = drawDebug;
+        gridDebug.Set(square, debug);
+    }
+
+    bool NavigationGridSystem::getFootprint(const BoundingBox& bb, Footprint& out) const
     {
         GridSquare topLeftIndex{};
         GridSquare bottomRightIndex{};
-        if (!WorldToGridSpace(occupant.min, topLeftIndex) || !WorldToGridSpace(occupant.max, bottomRightIndex))
+        if (!WorldToGridSpace(bb.min, topLeftIndex) || !WorldToGridSpace(bb.max, bottomRightIndex))
+        {
+            return false;
+        }
+
+        out.min = {
+            std::min(topLeftIndex.row, bottomRightIndex.row), std::min(topLeftIndex.col, bottomRightIndex.col)};
+        out.max = {
+            std::max(topLeftIndex.row, bottomRightIndex.row), std::max(topLeftIndex.col, bottomRightIndex.col)};
+        return true;
+    }
+
+    // Returns whether the square's static occupancy changed
+    bool NavigationGridSystem::setStaticSquare(
+        const GridSquare square, const bool occupied, const entt::entity occupant)
+    {
+        const bool changed = gridStaticOccupied.Get(square) != occupied;
+        gridStaticOccupied.Set(square, occupied);
+        gridStaticOccupant.Set(square, occupied ? occupant : entt::null);
+        const bool anyOccupied = occupied || gridDynamicCount.Get(square) > 0;
+        gridOccupied.Set(square, anyOccupied);
+        occupancyBits.Set(square, anyOccupied);
+        ++occupancyVersion;
+        return changed;
+    }
+
+    // Invalidates everything built from the static layer (as well as the combined layer) around the squares.
+    void NavigationGridSystem::markStaticChanged(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        ++staticOccupancyVersion;
+        recordOccupancyChange(minSquare, maxSquare);
+        clearanceMap.MarkDirty(minSquare, maxSquare);
+        staticClearanceMap.MarkDirty(minSquare, maxSquare);
+        connectivityMap.MarkChanged(minSquare, maxSquare);
+        nearestWalkableMap.MarkDirty(minSquare, maxSquare);
+        hierarchicalGrid.MarkDirty(minSquare, maxSquare);
+        pathCache.MarkChanged(minSquare, maxSquare);
+    }
+
+    void NavigationGridSystem::recordOccupancyChange(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        constexpr size_t maxChanges = 1024;
+
+        if (occupancyChanges.size() >= maxChanges)
         {
-            return;
+            constexpr auto dropped = static_cast<std::ptrdiff_t>(maxChanges / 2);
+            occupancyChanges.erase(occupancyChanges.begin(), occupancyChanges.begin() + dropped);
+            occupancyChangesDropped += dropped;
         }
+        occupancyChanges.push_back({minSquare, maxSquare});
+    }
+
+    void NavigationGridSystem::MarkSquareAreaOccupiedIfSteep(const BoundingBox& occupant, bool occupied)
+    {
+        Footprint footprint{};
+        if (!getFootprint(occupant, footprint)) return;
 
-        int min_col = std::min(topLeftIndex.col, bottomRightIndex.col);
-        int max_col = std::max(topLeftIndex.col, bottomRightIndex.col);
-        int min_row = std::min(topLeftIndex.row, bottomRightIndex.row);
-        int max_row = std::max(topLeftIndex.row, bottomRightIndex.row);
         Vector3 up = {0.0f, 1.0f, 0.0f};
+        bool staticChange = false;
 
-        for (int row = min_row; row <= max_row; ++row)
+        for (int row = footprint.min.row; row <= footprint.max.row; ++row)
         {
-            for (int col = min_col; col <= max_col; ++col)
+            for (int col = footprint.min.col; col <= footprint.max.col; ++col)
             {
-                auto normal = gridSquares[row][col]->terrainNormal;
+                auto normal = terrain.GetNormal({row, col});
                 // Calculate the angle between the normal and the up vector
                 float dotProduct = normal.x * up.x + normal.y * up.y + normal.z * up.z;
                 float angle = std::acos(dotProduct) * RAD2DEG; // Convert to degrees
@@ -145,52 +220,181 @@ namespace sage
                 // cost
                 if (angle > 45.0f)
                 {
-                    gridSquares[row][col]->occupied = occupied;
-                    gridSquares[row][col]->drawDebug = occupied;
+                    staticChange |= setStaticSquare({row, col}, occupied, gridStaticOccupant.Get({row, col}));
+                    setDrawDebug({row, col}, occupied);
                 }
             }
         }
+        if (staticChange)
+        {
+            markStaticChanged(footprint.min, footprint.max);
+        }
     }
 
+    // Static layer only. Moving actors go through QueueDynamicOccupant.
     void NavigationGridSystem::MarkSquareAreaOccupied(
-        const BoundingBox& occupant, bool occupied, entt::entity occupantEntity) const
+        const BoundingBox& occupant, bool occupied, entt::entity occupantEntity)
     {
-        GridSquare topLeftIndex{};
-        GridSquare bottomRightIndex{};
-        if (!WorldToGridSpace(occupant.min, topLeftIndex) || !WorldToGridSpace(occupant.max, bottomRightIndex))
+        Footprint footprint{};
+        if (!getFootprint(occupant, footprint)) return;
+
+        bool staticChange = false;
+        for (int row = footprint.min.row; row <= footprint.max.row; ++row)
+        {
+            for (int col = footprint.min.col; col <= footprint.max.col; ++col)
+            {
+                staticChange |= setStaticSquare({row, col}, occupied, occupantEntity);
+                setDrawDebug({row, col}, occupied);
+            }
+        }
+        if (staticChange)
+        {
+            markStaticChanged(footprint.min, footprint.max);
+        }
+    }
+
+    // Only clears the squares the entity itself occupies, leaving anything it overlaps in place
+    void NavigationGridSystem::RemoveStaticOccupant(const entt::entity entity, const BoundingBox& occupant)
+    {
+        Footprint footprint{};
+        if (!getFootprint(occupant, footprint)) return;
+
+        bool staticChange = false;
+        for (int row = footprint.min.row; row <= footprint.max.row; ++row)
+        {
+            for (int col = footprint.min.col; col <= footprint.max.col; ++col)
+            {
+                if (gridStaticOccupant.Get({row, col}) != entity) continue;
+                staticChange |= setStaticSquare({row, col}, false, entt::null);
+                setDrawDebug({row, col}, false);
+            }
+        }
+        if (staticChange)
         {
-            return;
+            markStaticChanged(footprint.min, footprint.max);
         }
+    }
 
-        int min_col = std::min(topLeftIndex.col, bottomRightIndex.col);
-        int max_col = std::max(topLeftIndex.col, bottomRightIndex.col);
-        int min_row = std::min(topLeftIndex.row, bottomRightIndex.row);
-        int max_row = std::max(topLeftIndex.row, bottomRightIndex.row);
+    void NavigationGridSystem::MarkSquaresOccupied(const std::vector<GridSquare>& squares, bool occupied)
+    {
+        for (const auto& square : squares)
+        {
+            if (setStaticSquare(square, occupied, gridStaticOccupant.Get(square)))
+            {
+                markStaticChanged(square, square);
+            }
+        }
+    }
 
-        for (int row = min_row; row <= max_row; ++row)
+    void NavigationGridSystem::applyDynamicFootprint(
+        const entt::entity entity, const Footprint& footprint, const bool add)
+    {
+        bool changed = false;
+        for (int row = footprint.min.row; row <= footprint.max.row; ++row)
         {
-            for (int col = min_col; col <= max_col; ++col)
+            for (int col = footprint.min.col; col <= footprint.max.col; ++col)
             {
-                gridSquares[row][col]->occupied = occupied;
-                gridSquares[row][col]->drawDebug = occupied;
-                if (occupied)
+                const GridSquare square{row, col};
+                const uint8_t count = gridDynamicCount.Get(square) + (add ? 1 : -1);
+                gridDynamicCount.Set(square, count);
+                if (add)
                 {
-                    gridSquares[row][col]->occupant = occupantEntity;
+                    gridDynamicOccupant.Set(square, entity);
                 }
-                else
+                else if (count == 0)
+                {
+                    gridDynamicOccupant.Set(square, entt::null);
+                }
+                else if (gridDynamicOccupant.Get(square) == entity)
+                {
+                    gridDynamicOccupant.Set(square, findDynamicOccupant(square, entity));
+                }
+
+                const bool occupied = gridStaticOccupied.Get(square) || count > 0;
+                if (gridOccupied.Get(square) != occupied)
                 {
-                    gridSquares[row][col]->occupant = entt::null;
+                    ++occupancyVersion;
+                    gridOccupied.Set(square, occupied);
+                    occupancyBits.Set(square, occupied);
+                    setDrawDebug(square, occupied);
+                    changed = true;
                 }
             }
         }
+        if (changed)
+        {
+            recordOccupancyChange(footprint.min, footprint.max);
+            clearanceMap.MarkDirty(footprint.min, footprint.max);
+            nearestWalkableMap.MarkDirty(footprint.min, footprint.max);
+        }
     }
 
-    void NavigationGridSystem::MarkSquaresOccupied(const std::vector<GridSquare>& squares, bool occupied) const
+    // Any moving actor other than "ignore" covering the square
+    entt::entity NavigationGridSystem::findDynamicOccupant(
+        const GridSquare square, const entt::entity ignore) const
     {
-        for (const auto& square : squares)
+        for (const auto& [entity, footprint] : dynamicFootprints)
+        {
+            if (entity != ignore && footprint.Contains(square)) return entity;
+        }
+        return entt::null;
+    }
+
+    // The occupant of a square, preferring moving actors to the static layer. Never returns "ignore".
+    entt::entity NavigationGridSystem::occupantAt(const GridSquare square, const entt::entity ignore) const
+    {
+        if (const auto count = gridDynamicCount.Get(square); count > 0)
+        {
+            if (const auto occupant = gridDynamicOccupant.Get(square); occupant != ignore) return occupant;
+            if (count > 1) return findDynamicOccupant(square, ignore);
+        }
+        const auto occupant = gridStaticOccupant.Get(square);
+        return occupant != ignore ? occupant : entt::null;
+    }
+
+    // Applied to the dynamic layer by the next FlushDynamicOccupants
+    void NavigationGridSystem::QueueDynamicOccupant(const entt::entity entity, const BoundingBox& bb)
+    {
+        pendingOccupants.emplace_back(entity, bb);
+    }
+
+    void NavigationGridSystem::FlushDynamicOccupants()
+    {
+        for (const auto& [entity, bb] : pendingOccupants)
+        {
+            PlaceDynamicOccupant(entity, bb);
+        }
+        pendingOccupants.clear();
+        // Here rather than when a route is asked for, so that queries do not pay for the last edit
+        hierarchicalGrid.Update();
+    }
+
+    void NavigationGridSystem::PlaceDynamicOccupant(const entt::entity entity, const BoundingBox& bb)
+    {
+        Footprint footprint{};
+        const bool inGrid = getFootprint(bb, footprint);
+        if (const auto it = dynamicFootprints.find(entity); it != dynamicFootprints.end())
         {
-            gridSquares[square.row][square.col]->occupied = occupied;
+            if (inGrid && it->second == footprint) return;
+            const auto previous = it->second;
+            dynamicFootprints.erase(it);
+            applyDynamicFootprint(entity, previous, false);
         }
+        if (!inGrid) return;
+
+        dynamicFootprints.emplace(entity, footprint);
+        applyDynamicFootprint(entity, footprint, true);
+    }
+
+    // Also drops anything queued for the actor
+    void NavigationGridSystem::RemoveDynamicOccupant(const entt::entity entity)
+    {
+        std::erase_if(pendingOccupants, [entity](const auto& pending) { return pending.first == entity; });
+        const auto it = dynamicFootprints.find(entity);
+        if (it == dynamicFootprints.end()) return;
+        const auto footprint = it->second;
+        dynamicFootprints.erase(it);
+        applyDynamicFootprint(entity, footprint, false);
     }
 
     void NavigationGridSystem::MarkSquaresDebug(
@@ -198,11 +402,13 @@ namespace sage
     {
         for (const auto& square : squares)
         {
-            gridSquares[square.row][square.col]->drawDebug = occupied;
+            auto debug = gridDebug.Get(square);
+            debug.drawDebug = occupied;
             if (occupied)
             {
-                gridSquares[square.row][square.col]->debugColor = color;
+                debug.debugColor = color;
             }
+            gridDebug.Set(square, debug);
         }
     }
 
@@ -218,7 +424,7 @@ namespace sage
 
     bool NavigationGridSystem::CheckSingleSquareOccupied(GridSquare position) const
     {
-        return gridSquares[position.row][position.col]->occupied;
+        return gridOccupied.Get(position);
     }
 
     /**
@@ -227,7 +433,8 @@ namespace sage
      * @param bb
      * @return
      */
-    bool NavigationGridSystem::CheckBoundingBoxAreaUnoccupied(Vector3 worldPos, const BoundingBox& bb) const
+    bool NavigationGridSystem::CheckBoundingBoxAreaUnoccupied(
+        Vector3 worldPos, const BoundingBox& bb, const entt::entity ignore) const
     {
         GridSquare gridPos{};
         if (!WorldToGridSpace(worldPos, gridPos))
@@ -235,10 +442,12 @@ namespace sage
             return false;
         }
 
-        return CheckBoundingBoxAreaUnoccupied(gridPos, bb);
+        return CheckBoundingBoxAreaUnoccupied(gridPos, bb, ignore);
     }
 
-    bool NavigationGridSystem::CheckBoundingBoxAreaUnoccupied(GridSquare square, const BoundingBox& bb) const
+    // Squares occupied only by "ignore" count as free
+    bool NavigationGridSystem::CheckBoundingBoxAreaUnoccupied(
+        GridSquare square, const BoundingBox& bb, const entt::entity ignore) const
     {
         GridSquare extents{};
         {
@@ -250,7 +459,27 @@ namespace sage
 
             extents -= bb_min;
         }
-        return checkExtents(square, extents);
+        if (checkExtents(square, extents)) return true;
+
+        // Blocked, but possibly only by "ignore" itself
+        const auto it = dynamicFootprints.find(ignore);
+        if (it == dynamicFootprints.end()) return false;
+        const auto& own = it->second;
+        const auto min = square - extents;
+        const auto max = square + extents;
+        for (int row = min.row; row < max.row; ++row)
+        {
+            for (int col = min.col; col < max.col; ++col)
+            {
+                const GridSquare other{row, col};
+                if (!CheckWithinGridBounds(other)) return false;
+                if (gridStaticOccupied.Get(other) || gridDynamicCount.Get(other) > (own.Contains(other) ? 1 : 0))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
     }
 
     entt::entity NavigationGridSystem::CheckSingleSquareOccupant(Vector3 worldPos) const
@@ -265,7 +494,7 @@ namespace sage
 
     entt::entity NavigationGridSystem::CheckSingleSquareOccupant(GridSquare position) const
     {
-        return gridSquares[position.row][position.col]->occupant;
+        return occupantAt(position);
     }
 
     entt::entity NavigationGridSystem::CheckSquareAreaOccupant(Vector3 worldPos, const BoundingBox& bb) const
@@ -295,21 +524,17 @@ namespace sage
             return entt::null;
         }
 
-        if (gridSquares[square.row - extents.row][square.col - extents.col]->occupied)
+        const GridSquare corners[] = {
+            {square.row - extents.row, square.col - extents.col},
+            {square.row + extents.row, square.col + extents.col},
+            {square.row - extents.row, square.col + extents.col},
+            {square.row + extents.row, square.col - extents.col}};
+        for (const auto corner : corners)
         {
-            return gridSquares[square.row - extents.row][square.col - extents.col]->occupant;
-        }
-        if (gridSquares[square.row + extents.row][square.col + extents.col]->occupied)
-        {
-            return gridSquares[square.row + extents.row][square.col + extents.col]->occupant;
-        }
-        if (gridSquares[square.row - extents.row][square.col + extents.col]->occupied)
-        {
-            return gridSquares[square.row - extents.row][square.col + extents.col]->occupant;
-        }
-        if (gridSquares[square.row + extents.row][square.col - extents.col]->occupied)
-        {
-            return gridSquares[square.row + extents.row][square.col - extents.col]->occupant;
+            if (gridOccupied.Get(corner))
+            {
+                return occupantAt(corner);
+            }
         }
         return entt::null;
     }
@@ -344,83 +569,77 @@ namespace sage
         return 1.0f + (angle / maxSlopeAngle);
     }
 
-    void NavigationGridSystem::calculateTerrainHeightAndNormals(const entt::entity& entity)
+    // A floor or stairs, resolved up front so that the bake does not touch the registry
+    struct NavigationGridSystem::TerrainSource
     {
-        const auto& area = registry->get<Collideable>(entity).worldBoundingBox;
-
-        GridSquare topLeftIndex{}, bottomRightIndex{};
-        if (!WorldToGridSpace(area.min, topLeftIndex) || !WorldToGridSpace(area.max, bottomRightIndex))
-        {
-            return;
-        }
-
-        const auto& renderable = registry->get<Renderable>(entity);
-        const auto& transform = registry->get<sgTransform>(entity);
-        const auto& collideable = registry->get<Collideable>(entity);
-
-        const int min_col = std::max(0, std::min(topLeftIndex.col, bottomRightIndex.col));
-        const int max_col = std::min(
-            static_cast<int>(gridSquares[0].size()) - 1, std::max(topLeftIndex.col, bottomRightIndex.col));
-        const int min_row = std::max(0, std::min(topLeftIndex.row, bottomRightIndex.row));
-        const int max_row =
-            std::min(static_cast<int>(gridSquares.size()) - 1, std::max(topLeftIndex.row, bottomRightIndex.row));
-
-        for (int row = min_row; row <= max_row; ++row)
+        CollisionLayer layer;
+        BoundingBox area;
+        Footprint squares;
+        // FLOORCOMPLEX only: the mesh's triangles (in mesh space) and the mesh's world transform
+        const TriangleBvh* bvh = nullptr;
+        Matrix transform{};
+    };
+
+    void NavigationGridSystem::calculateTerrainHeightAndNormals(
+        const TerrainSource& source, const int firstRow, const int lastRow)
+    {
+        const auto& area = source.area;
+        const int minRow = std::max(firstRow, source.squares.min.row);
+        const int maxRow = std::min(lastRow, source.squares.max.row);
+        for (int row = minRow; row <= maxRow; ++row)
         {
-            for (int col = min_col; col <= max_col; ++col)
+            for (int col = source.squares.min.col; col <= source.squares.max.col; ++col)
             {
-                if (collideable.collisionLayer == CollisionLayer::STAIRS)
+                const auto worldPosMin = getWorldPosMin(row, col);
+                // NB: Unset heights are NAVIGATION_GRID_NO_HEIGHT, so any height will be greater.
+                auto& height = terrain.Height({row, col});
+                auto& normal = terrain.Normal({row, col});
+
+                if (source.layer == CollisionLayer::STAIRS)
                 {
-                    float relativeX =
-                        (gridSquares[row][col]->worldPosMin.x - area.min.x) / (area.max.x - area.min.x);
-                    float relativeZ =
-                        (gridSquares[row][col]->worldPosMin.z - area.min.z) / (area.max.z - area.min.z);
+                    float relativeX = (worldPosMin.x - area.min.x) / (area.max.x - area.min.x);
+                    float relativeZ = (worldPosMin.z - area.min.z) / (area.max.z - area.min.z);
                     Vector3 stairDirection = Vector3Normalize(Vector3Subtract(area.max, area.min));
                     float relativePosition = relativeX * stairDirection.x + relativeZ * stairDirection.z;
                     float interpolatedHeight = area.min.y + (area.max.y - area.min.y) * relativePosition;
 
-                    if (!gridSquares[row][col]->terrainHeight.has_value() ||
-                        gridSquares[row][col]->terrainHeight < interpolatedHeight)
+                    if (height < interpolatedHeight)
                     {
-                        gridSquares[row][col]->terrainHeight = interpolatedHeight;
-                        gridSquares[row][col]->terrainNormal =
-                            Vector3Normalize(Vector3{-stairDirection.x, 1, -stairDirection.z});
+                        height = interpolatedHeight;
+                        normal = Vector3Normalize(Vector3{-stairDirection.x, 1, -stairDirection.z});
 
                         // float stairSlope = (area.max.y - area.min.y) / (area.max - area.min).Length();
-                        // gridSquares[row][col]->pathfindingCost = calculateStairsCost(stairSlope);
+                        // gridPathfindingCost[idx] = calculateStairsCost(stairSlope);
                     }
                 }
-                else if (collideable.collisionLayer == CollisionLayer::FLOORSIMPLE)
+                else if (source.layer == CollisionLayer::FLOORSIMPLE)
                 {
-                    if (!gridSquares[row][col]->terrainHeight.has_value() ||
-                        gridSquares[row][col]->terrainHeight < area.max.y)
+                    if (height < area.max.y)
                     {
-                        gridSquares[row][col]->terrainHeight = area.max.y;
-                        gridSquares[row][col]->terrainNormal = {0, 1, 0};
-                        // gridSquares[row][col]->pathfindingCost =
+                        height = area.max.y;
+                        normal = {0, 1, 0};
+                        // gridPathfindingCost[idx] =
                         // calculateTerrainCost(getFirstCollision.normal, 45.0f);
                     }
                 }
-                else if (collideable.collisionLayer == CollisionLayer::FLOORCOMPLEX)
+                else if (source.layer == CollisionLayer::FLOORCOMPLEX)
                 {
                     Vector3 gridCenter = {
-                        (gridSquares[row][col]->worldPosMin.x + gridSquares[row][col]->worldPosMax.x) * 0.5f,
+                        worldPosMin.x + spacing * 0.5f,
                         area.max.y + 1.0f, // Start slightly above the terrain
-                        (gridSquares[row][col]->worldPosMin.z + gridSquares[row][col]->worldPosMax.z) * 0.5f};
+                        worldPosMin.z + spacing * 0.5f};
 
                     Ray ray = {gridCenter, {0, -1, 0}}; // Cast ray down
 
-                    RayCollision getFirstCollision =
-                        renderable.GetModel()->GetRayMeshCollision(ray, 0, transform.GetMatrix());
+                    RayCollision getFirstCollision = source.bvh->GetRayCollision(ray, source.transform);
 
                     if (getFirstCollision.hit)
                     {
-                        if (!gridSquares[row][col]->terrainHeight.has_value() ||
-                            gridSquares[row][col]->terrainHeight < getFirstCollision.point.y)
+                        if (height < getFirstCollision.point.y)
                         {
-                            gridSquares[row][col]->terrainHeight = getFirstCollision.point.y;
-                            gridSquares[row][col]->terrainNormal = getFirstCollision.normal;
-                            // gridSquares[row][col]->pathfindingCost =
+                            height = getFirstCollision.point.y;
+                            normal = getFirstCollision.normal;
+                            // gridPathfindingCost[idx] =
                             // calculateTerrainCost(getFirstCollision.normal, 45.0f);
                         }
                     }
@@ -431,15 +650,13 @@ namespace sage
 
     void NavigationGridSystem::GenerateNormalMap(ImageSafe& image)
     {
-        int slices = gridSquares.size();
-
         Image normalMap = GenImageColor(slices, slices, BLACK);
         std::cout << "START: Generating normal map..." << std::endl;
         for (int y = 0; y < slices; ++y)
         {
             for (int x = 0; x < slices; ++x)
             {
-                auto normal = gridSquares[y][x]->terrainNormal;
+                auto normal = terrain.GetNormal({y, x});
 
                 // Map the normal components from [-1, 1] to [0, 255]
                 auto r = static_cast<unsigned char>((normal.x + 1.0f) * 127.5f);
@@ -497,7 +714,6 @@ namespace sage
 
     void NavigationGridSystem::GenerateHeightMap(ImageSafe& image)
     {
-        int slices = gridSquares.size();
         auto [minHeight, maxHeight] = getHeightBounds(slices);
         float heightRange = maxHeight - minHeight;
 
@@ -507,7 +723,7 @@ namespace sage
         {
             for (int x = 0; x < slices; ++x)
             {
-                float height = *gridSquares[y][x]->terrainHeight;
+                float height = terrain.GetHeight({y, x});
 
                 auto heightValue = static_cast<unsigned char>(((height - minHeight) / heightRange) * 255.0f);
 
@@ -519,6 +735,14 @@ namespace sage
         std::cout << "FINISH: Generating height map..." << std::endl;
     }
 
+    void NavigationGridSystem::GenerateHeightfield(Heightfield& heightfield) const
+    {
+        std::vector<float> heights;
+        std::vector<Vector3> normals;
+        terrain.Flatten(heights, normals);
+        heightfield.Pack(slices, heights, normals);
+    }
+
     void NavigationGridSystem::loadTerrainNormalMap(const ImageSafe& normalMap)
     {
         std::cout << "START: Applying terrain normal map to grid. \n";
@@ -543,7 +767,7 @@ namespace sage
                 // Assign the normal to the corresponding grid square
                 if (i >= 0 && i < slices && j >= 0 && j < slices)
                 {
-                    gridSquares[j][i]->terrainNormal = normal;
+                    terrain.Normal({j, i}) = normal;
                 }
             }
         }
@@ -556,7 +780,6 @@ namespace sage
         std::cout << "START: Applying terrain height map to grid. \n";
         auto [minHeight, maxHeight] = getHeightBounds(slices);
         float heightRange = maxHeight - minHeight;
-        int halfSlices = slices / 2;
 
         for (int j = 0; j < slices; ++j)
         {
@@ -576,7 +799,7 @@ namespace sage
 
                 if (gridX >= 0 && gridX < slices && gridY >= 0 && gridY < slices)
                 {
-                    gridSquares[gridY][gridX]->terrainHeight = height;
+                    terrain.Height({gridY, gridX}) = height;
                 }
             }
         }
@@ -672,8 +895,8 @@ namespace sage
         // Clamp to grid
         topLeftIndex.col = std::max(topLeftIndex.col, 0);
         topLeftIndex.row = std::max(topLeftIndex.row, 0);
-        bottomRightIndex.col = std::min(bottomRightIndex.col, static_cast<int>(gridSquares.at(0).size() - 1));
-        bottomRightIndex.row = std::min(bottomRightIndex.row, static_cast<int>(gridSquares.size() - 1));
+        bottomRightIndex.col = std::min(bottomRightIndex.col, slices - 1);
+        bottomRightIndex.row = std::min(bottomRightIndex.row, slices - 1);
 
         minRange = {topLeftIndex.row, topLeftIndex.col};
         maxRange = {bottomRightIndex.row, bottomRightIndex.col};
@@ -683,12 +906,11 @@ namespace sage
 
     bool NavigationGridSystem::GridToWorldSpace(GridSquare gridPos, Vector3& out) const
     {
-        GridSquare maxRange = {static_cast<int>(gridSquares.at(0).size()), static_cast<int>(gridSquares.size())};
-        if (!CheckWithinBounds(gridPos, {0, 0}, maxRange))
+        if (!CheckWithinGridBounds(gridPos))
         {
             return false;
         }
-        out = gridSquares[gridPos.row][gridPos.col]->worldPosMin; // Not centre?
+        out = getWorldPosMin(gridPos.row, gridPos.col); // Not centre?
         return true;
     }
 
@@ -698,7 +920,7 @@ namespace sage
             worldPos,
             out,
             {0, 0},
-            {static_cast<int>(gridSquares.at(0).size()), static_cast<int>(gridSquares.size())});
+            {slices, slices});
     }
 
     bool NavigationGridSystem::WorldToGridSpace(
@@ -715,66 +937,242 @@ namespace sage
     void NavigationGridSystem::DrawDebug() const
     {
         return;
-        for (const auto& gridSquareRow : gridSquares)
-        {
-            for (const auto& gridSquare : gridSquareRow)
-            {
-                if (!gridSquare->drawDebug) continue;
-                DrawCubeWires(
-                    gridSquare->worldPosCentre,
-                    gridSquare->debugBox.x,
-                    gridSquare->debugBox.y,
-                    gridSquare->debugBox.z,
-                    gridSquare->debugColor);
-            }
-        }
+        gridDebug.ForEachChanged([this](const GridSquare square, const NavigationGridSquareDebug& debug) {
+            if (!debug.drawDebug) return;
+            const auto worldPosMin = getWorldPosMin(square.row, square.col);
+            DrawCubeWires(
+                {worldPosMin.x + spacing * 0.5f, 0.5f, worldPosMin.z + spacing * 0.5f},
+                spacing,
+                0.1f,
+                spacing,
+                debug.debugColor);
+        });
     }
 
     std::vector<Vector3> NavigationGridSystem::tracebackPath(
-        const std::vector<std::vector<GridSquare>>& came_from,
+        const PathfindingContext& context,
         const GridSquare& start,
-        const GridSquare& finish) const
+        const GridSquare& finish,
+        const GridSquare& extents) const
+    {
+        return tracebackPath(collectPath(context, start, finish), extents);
+    }
+
+    // Waypoints for the squares the route turns at (see stringPull)
+    std::vector<Vector3> NavigationGridSystem::tracebackPath(
+        const std::vector<GridSquare>& squares, const GridSquare& extents) const
     {
         auto combineWorldPosTerrainHeight = [this](auto gridPos) {
-            Vector3 worldPos = gridSquares[gridPos.row][gridPos.col]->worldPosMin;
-            worldPos.y = *gridSquares[gridPos.row][gridPos.col]->terrainHeight;
+            Vector3 worldPos = getWorldPosMin(gridPos.row, gridPos.col);
+            worldPos.y = terrain.GetHeight(gridPos);
             return worldPos;
         };
+
+        const auto corners = stringPull(squares, extents);
         std::vector<Vector3> path;
-        GridSquare current = {finish.row, finish.col};
-        GridSquare previous{};
-        std::pair<int, int> currentDir = {0, 0};
+        path.reserve(corners.size());
+        // The start is left out to stop "stuttering" when holding left click
+        for (size_t i = 1; i < corners.size(); ++i)
+        {
+            path.push_back(combineWorldPosTerrainHeight(corners[i]));
+        }
+        if (path.empty() && !corners.empty())
+        {
+            path.push_back(combineWorldPosTerrainHeight(corners.front()));
+        }
+        return path;
+    }
+
+    std::vector<GridSquare> NavigationGridSystem::stringPull(
+        const std::vector<GridSquare>& squares, const GridSquare& extents) const
+    {
+        std::vector<GridSquare> corners;
+        if (squares.empty()) return corners;
 
-        path.push_back(combineWorldPosTerrainHeight(current));
-        while (current.row != start.row || current.col != start.col)
+        corners.push_back(squares.front());
+        size_t anchor = 0;
+        for (size_t i = 2; i < squares.size(); ++i)
+        {
+            if (!hasLineOfSight(squares[anchor], squares[i], extents))
+            {
+                anchor = i - 1;
+                corners.push_back(squares[anchor]);
+            }
+        }
+        if (squares.size() > 1)
         {
-            previous = current;
-            current = came_from[current.row][current.col];
-            for (const auto& dir : directions)
+            corners.push_back(squares.back());
+        }
+        return corners;
+    }
+
+    // Actors travel between square corners, so the squares around each corner on the line are checked
+    bool NavigationGridSystem::hasLineOfSight(GridSquare from, GridSquare to, const GridSquare& extents) const
+    {
+        // Whether every square between min and max (inclusive) is walkable
+        auto clear = [this, &extents](GridSquare min, GridSquare max) {
+            if (occupancyView.occupancy == nullptr)
             {
-                int row = previous.row + dir.first;
-                int col = previous.col + dir.second;
-                if (row == current.row && col == current.col)
+                // Together, the squares' footprints cover one area, which is checked a row of words at a time
+                if (extents.row > 0 && extents.col > 0)
                 {
-                    if (currentDir.first == 0 && currentDir.second == 0)
-                    {
-                        currentDir = dir;
-                        break;
-                    }
-                    if (dir != currentDir)
-                    {
-                        currentDir = dir;
-                        path.push_back(combineWorldPosTerrainHeight(previous));
-                        path.push_back(combineWorldPosTerrainHeight(current));
-                    }
-                    break;
+                    min -= extents;
+                    max += extents;
+                }
+                else
+                {
+                    max += {1, 1};
+                }
+                return min.row >= 0 && min.col >= 0 && max.row <= slices && max.col <= slices &&
+                       !occupancyBits.AnyInArea(min, max);
+            }
+            for (int row = min.row; row <= max.row; ++row)
+            {
+                for (int col = min.col; col <= max.col; ++col)
+                {
+                    if (!isWalkable({row, col}, extents, {0, 0}, {slices, slices})) return false;
                 }
             }
+            return true;
+        };
+        // Rounds towards negative infinity, for a positive denominator
+        auto floorDiv = [](const int numerator, const int denominator) {
+            return numerator >= 0 ? numerator / denominator : -((denominator - 1 - numerator) / denominator);
+        };
+
+        if (from.col > to.col) std::swap(from, to);
+        const int dRow = to.row - from.row;
+        const int dCol = to.col - from.col;
+
+        if (dCol == 0)
+        {
+            return clear({std::min(from.row, to.row), from.col}, {std::max(from.row, to.row), from.col});
         }
-        // Commented out the first node to stop "stuttering" bug when holding left click
-        // path.push_back(combineWorldPosTerrainHeight(current));
-        std::ranges::reverse(path);
-        return path;
+
+        // Heights at each column are kept as whole numbers over dCol
+        for (int col = from.col; col < to.col; ++col)
+        {
+            const int rowAtCol = from.row * dCol + (col - from.col) * dRow;
+            const int rowAtNextCol = rowAtCol + dRow;
+            const int minRow = floorDiv(std::min(rowAtCol, rowAtNextCol), dCol);
+            const int maxRow = -floorDiv(-std::max(rowAtCol, rowAtNextCol), dCol);
+            if (!clear({minRow, col}, {maxRow, col + 1})) return false;
+        }
+        return true;
+    }
+
+    // Sections that would cross an occupied square are left straight
+    std::vector<Vector3> NavigationGridSystem::CurvePath(
+        const entt::entity& entity,
+        const Vector3& startPos,
+        const std::vector<Vector3>& path,
+        const float sampleSpacing) const
+    {
+        // Enough to measure each section's length to within a small fraction of a square
+        constexpr int lengthSteps = 16;
+
+        GridSquare extents{};
+        if (path.empty() || sampleSpacing <= 0 || !getExtents(entity, extents)) return path;
+
+        std::vector<Vector3> points;
+        points.reserve(path.size() + 1);
+        points.push_back(startPos);
+        points.insert(points.end(), path.begin(), path.end());
+
+        std::vector<Vector3> curved;
+        std::array<Vector3, lengthSteps + 1> steps{};
+        std::array<float, lengthSteps + 1> lengths{};
+        for (size_t i = 0; i + 1 < points.size(); ++i)
+        {
+            const auto& p0 = points[i == 0 ? 0 : i - 1];
+            const auto& p1 = points[i];
+            const auto& p2 = points[i + 1];
+            const auto& p3 = points[std::min(i + 2, points.size() - 1)];
+
+            for (int step = 0; step <= lengthSteps; ++step)
+            {
+                steps[step] = catmullRom(p0, p1, p2, p3, static_cast<float>(step) / lengthSteps);
+                lengths[step] = step == 0 ? 0
+                                          : lengths[step - 1] + Vector2Distance(
+                                                                    {steps[step].x, steps[step].z},
+                                                                    {steps[step - 1].x, steps[step - 1].z});
+            }
+
+            const size_t sectionStart = curved.size();
+            bool clear = true;
+            int step = 1;
+            for (float distance = sampleSpacing; distance < lengths[lengthSteps]; distance += sampleSpacing)
+            {
+                while (lengths[step] < distance)
+                {
+                    ++step;
+                }
+                const float t = (distance - lengths[step - 1]) / (lengths[step] - lengths[step - 1]);
+                Vector3 sample = Vector3Lerp(steps[step - 1], steps[step], t);
+
+                // As in hasLineOfSight, the footprints at the corners around a point cover the footprint there
+                GridSquare square{};
+                clear = WorldToGridSpace(sample, square);
+                for (const auto& corner : {GridSquare{0, 0}, GridSquare{0, 1}, GridSquare{1, 0}, GridSquare{1, 1}})
+                {
+                    clear = clear && isWalkable(square + corner, extents, {0, 0}, {slices, slices});
+                }
+                if (!clear) break;
+
+                sample.y = terrain.GetHeight(square);
+                curved.push_back(sample);
+            }
+
+            if (!clear)
+            {
+                curved.resize(sectionStart);
+            }
+            curved.push_back(p2);
+        }
+
+        return curved;
+    }
+
+    std::vector<GridSquare> NavigationGridSystem::collectPath(
+        const PathfindingContext& context, const GridSquare& start, const GridSquare& finish) const
+    {
+        std::vector<GridSquare> squares;
+        for (GridSquare current = finish; current != start; current = context.CameFrom(index(current)))
+        {
+            squares.push_back(current);
+        }
+        squares.push_back(start);
+        std::ranges::reverse(squares);
+        return squares;
+    }
+
+    // Main thread only. The cache does not track moving actors, so the rest of the path is rechecked.
+    bool NavigationGridSystem::findCachedPath(
+        const PathCacheKey& key,
+        const GridSquare& start,
+        const GridSquare& minRange,
+        const GridSquare& maxRange,
+        std::vector<Vector3>& path) const
+    {
+        std::vector<GridSquare> squares;
+        if (!pathCache.Find(key, start, squares))
+        {
+            pathCache.RecordMiss();
+            return false;
+        }
+
+        for (size_t i = 1; i < squares.size(); ++i)
+        {
+            if (!isWalkable(squares[i], key.extents, minRange, maxRange))
+            {
+                pathCache.RecordMiss();
+                return false;
+            }
+        }
+
+        pathCache.RecordHit();
+        path = tracebackPath(squares, key.extents);
+        return true;
     }
 
     bool NavigationGridSystem::CheckWithinGridBounds(Vector3 worldPos) const
@@ -788,7 +1186,7 @@ namespace sage
         return CheckWithinBounds(
             square,
             GridSquare{0, 0},
-            GridSquare{static_cast<int>(gridSquares.at(0).size()), static_cast<int>(gridSquares.size())});
+            GridSquare{slices, slices});
     }
 
     bool NavigationGridSystem::CheckWithinBounds(Vector3 worldPos, GridSquare minRange, GridSquare maxRange) const
@@ -797,14 +1195,30 @@ namespace sage
         return WorldToGridSpace(worldPos, tmp, minRange, maxRange);
     }
 
-    bool NavigationGridSystem::CheckWithinBounds(GridSquare square, GridSquare minRange, GridSquare maxRange)
+    // Occupancy as seen by searches. Reads the job's snapshot when running on a worker (see RunPathfindJob).
+    bool NavigationGridSystem::isOccupied(const GridSquare square) const
     {
-        return minRange.row <= square.row && square.row < maxRange.row && minRange.col <= square.col &&
-               square.col < maxRange.col;
+        if (occupancyView.occupancy == nullptr)
+        {
+            return gridOccupied.Get(square);
+        }
+        if (square.row >= occupancyView.ignoreMin.row && square.row <= occupancyView.ignoreMax.row &&
+            square.col >= occupancyView.ignoreMin.col && square.col <= occupancyView.ignoreMax.col)
+        {
+            return false;
+        }
+        return occupancyView.occupancy->IsOccupied(square);
     }
 
     bool NavigationGridSystem::checkExtents(const GridSquare square, const GridSquare extents) const
     {
+        // Worker threads read an occupancy snapshot, which the clearance map does not describe
+        if (occupancyView.occupancy == nullptr)
+        {
+            clearanceMap.Update(gridOccupied);
+            if (const auto fits = clearanceMap.Fits(square, extents)) return *fits;
+        }
+
         const auto min = square - extents;
         const auto max = square + extents;
 
@@ -812,7 +1226,7 @@ namespace sage
         {
             for (int col = min.col; col < max.col; ++col)
             {
-                if (!CheckWithinGridBounds(GridSquare{row, col}) || gridSquares[row][col]->occupied)
+                if (!CheckWithinGridBounds(GridSquare{row, col}) || isOccupied({row, col}))
                 {
                     return false;
                 }
@@ -822,38 +1236,397 @@ namespace sage
         return true;
     }
 
-    NavigationGridSquare* NavigationGridSystem::CastRay(
-        int currentRow,
-        int currentCol,
-        Vector2 direction,
-        float distance,
-        std::vector<GridSquare>& debugLines) const
+    bool NavigationGridSystem::isWalkable(
+        const GridSquare square,
+        const GridSquare extents,
+        const GridSquare minRange,
+        const GridSquare maxRange) const
     {
-        int dist = std::round(distance);
-        direction = Vector2Normalize(direction);
-        int dirRow = std::round(direction.y);
-        int dirCol = std::round(direction.x);
+        return CheckWithinBounds(square, minRange, maxRange) && !isOccupied(square) &&
+               checkExtents(square, extents);
+    }
 
-        for (int i = 0; i < dist; ++i)
+    // As checkExtents, but only reads the static layer, so squares covered by moving actors count as free.
+    bool NavigationGridSystem::isStaticallyWalkable(const GridSquare square, const GridSquare extents) const
+    {
+        // Worker threads only have the occupancy snapshot, in which moving actors block as well
+        if (occupancyView.occupancy != nullptr)
         {
-            GridSquare square = {currentRow + (dirRow * i), currentCol + (dirCol * i)};
-            debugLines.push_back(square);
+            return isWalkable(square, extents, {0, 0}, {slices, slices});
+        }
 
-            if (!CheckWithinGridBounds(square))
-            {
-                continue;
-            }
+        if (!CheckWithinGridBounds(square) || gridStaticOccupied.Get(square)) return false;
 
-            const auto cell = gridSquares[square.row][square.col].get();
-            cell->drawDebug = true;
-            cell->debugColor = PURPLE;
+        staticClearanceMap.Update(gridStaticOccupied);
+        if (const auto fits = staticClearanceMap.Fits(square, extents)) return *fits;
 
-            if (cell->occupant != entt::null)
-            {
-                return cell;
-            }
-        }
-        return nullptr;
+        const auto min = square - extents;
+        const auto max = square + extents;
+        for (int row = min.row; row < max.row; ++row)
+        {
+            for (int col = min.col; col < max.col; ++col)
+            {
+                if (!CheckWithinGridBounds(GridSquare{row, col}) || gridStaticOccupied.Get({row, col}))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Diagonals may cut corners, to match AStarPathfind
+    bool NavigationGridSystem::jump(
+        GridSquare from,
+        const GridSquare dir,
+        const GridSquare& finish,
+        const GridSquare& extents,
+        const GridSquare& minRange,
+        const GridSquare& maxRange,
+        GridSquare& out) const
+    {
+        auto walkable = [&](const int row, const int col) {
+            return isWalkable({row, col}, extents, minRange, maxRange);
+        };
+
+        const auto [dRow, dCol] = dir;
+        GridSquare current = from;
+        while (true)
+        {
+            current = current + dir;
+            const auto [row, col] = current;
+            if (!walkable(row, col)) return false;
+            if (current == finish) break;
+
+            if (dRow != 0 && dCol != 0)
+            {
+                if ((walkable(row - dRow, col + dCol) && !walkable(row - dRow, col)) ||
+                    (walkable(row + dRow, col - dCol) && !walkable(row, col - dCol)))
+                {
+                    break;
+                }
+                GridSquare unused{};
+                if (jump(current, {dRow, 0}, finish, extents, minRange, maxRange, unused) ||
+                    jump(current, {0, dCol}, finish, extents, minRange, maxRange, unused))
+                {
+                    break;
+                }
+            }
+            else if (dRow != 0)
+            {
+                if ((walkable(row + dRow, col + 1) && !walkable(row, col + 1)) ||
+                    (walkable(row + dRow, col - 1) && !walkable(row, col - 1)))
+                {
+                    break;
+                }
+            }
+            else
+            {
+                if ((walkable(row + 1, col + dCol) && !walkable(row + 1, col)) ||
+                    (walkable(row - 1, col + dCol) && !walkable(row - 1, col)))
+                {
+                    break;
+                }
+            }
+        }
+
+        out = current;
+        return true;
+    }
+
+    // Leaves the came_from chain in the thread's PathfindingContext
+    bool NavigationGridSystem::jumpPointSearch(
+        const GridSquare& start,
+        const GridSquare& finish,
+        const GridSquare& extents,
+        const GridSquare& minRange,
+        const GridSquare& maxRange) const
+    {
+        auto walkable = [&](const int row, const int col) {
+            return isWalkable({row, col}, extents, minRange, maxRange);
+        };
+
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
+
+        context.Push(octileDistance(start, finish), start);
+        context.Visit(index(start), start);
+
+        std::vector<GridSquare> neighbours;
+        neighbours.reserve(8);
+        bool pathFound = false;
+
+        while (!context.HeapEmpty())
+        {
+            const auto current = context.Pop().square;
+            if (current == finish)
+            {
+                pathFound = true;
+                break;
+            }
+
+            // Prune neighbours based on the direction we arrived from
+            neighbours.clear();
+            const auto parent = context.CameFrom(index(current));
+            const auto [row, col] = current;
+            const int dRow = (current.row > parent.row) - (current.row < parent.row);
+            const int dCol = (current.col > parent.col) - (current.col < parent.col);
+            if (dRow == 0 && dCol == 0)
+            {
+                for (const auto& [dirRow, dirCol] : DIRECTIONS)
+                {
+                    neighbours.push_back({dirRow, dirCol});
+                }
+            }
+            else if (dRow != 0 && dCol != 0)
+            {
+                neighbours.push_back({0, dCol});
+                neighbours.push_back({dRow, 0});
+                neighbours.push_back({dRow, dCol});
+                if (!walkable(row - dRow, col)) neighbours.push_back({-dRow, dCol});
+                if (!walkable(row, col - dCol)) neighbours.push_back({dRow, -dCol});
+            }
+            else if (dRow != 0)
+            {
+                neighbours.push_back({dRow, 0});
+                if (!walkable(row, col + 1)) neighbours.push_back({dRow, 1});
+                if (!walkable(row, col - 1)) neighbours.push_back({dRow, -1});
+            }
+            else
+            {
+                neighbours.push_back({0, dCol});
+                if (!walkable(row + 1, col)) neighbours.push_back({1, dCol});
+                if (!walkable(row - 1, col)) neighbours.push_back({-1, dCol});
+            }
+
+            for (const auto& dir : neighbours)
+            {
+                GridSquare jumpPoint{};
+                if (!jump(current, dir, finish, extents, minRange, maxRange, jumpPoint)) continue;
+
+                const double newCost = context.CostSoFar(index(current)) + octileDistance(current, jumpPoint);
+                if (!context.IsVisited(index(jumpPoint)) || newCost < context.CostSoFar(index(jumpPoint)))
+                {
+                    context.Visit(index(jumpPoint), current, newCost);
+                    context.Push(newCost + octileDistance(jumpPoint, finish), jumpPoint, newCost);
+                }
+            }
+        }
+
+        if (!pathFound)
+        {
+            return false;
+        }
+
+        // Fill in the squares between each pair of jump points, so came_from is a chain of adjacent squares.
+        std::vector<GridSquare> jumpPoints;
+        for (GridSquare square = finish; square != start; square = context.CameFrom(index(square)))
+        {
+            jumpPoints.push_back(square);
+        }
+        jumpPoints.push_back(start);
+
+        for (size_t i = 0; i + 1 < jumpPoints.size(); ++i)
+        {
+            const auto to = jumpPoints[i];
+            const auto from = jumpPoints[i + 1];
+            const GridSquare step = {
+                (to.row > from.row) - (to.row < from.row), (to.col > from.col) - (to.col < from.col)};
+            for (GridSquare square = to; square != from; square -= step)
+            {
+                context.Visit(index(square), square - step);
+            }
+        }
+
+        return true;
+    }
+
+    // Walks the ray a row at a time, testing each run of columns against occupancyBits
+    entt::entity NavigationGridSystem::CastRay(
+        const int currentRow,
+        const int currentCol,
+        Vector2 direction,
+        const float distance,
+        const entt::entity ignore,
+        std::vector<GridSquare>* debugLines) const
+    {
+        direction = Vector2Normalize(direction);
+        // Positions are kept relative to the start square, so that precision does not depend on where the ray is
+        const float endRow = 0.5f + direction.y * distance;
+        const int rowStep = direction.y < 0 ? -1 : 1;
+        int lastRow = currentRow;
+        if (direction.y > 0)
+        {
+            lastRow = currentRow + static_cast<int>(std::ceil(endRow)) - 1;
+        }
+        else if (direction.y < 0)
+        {
+            lastRow = currentRow + static_cast<int>(std::floor(endRow));
+        }
+
+        // Columns are tracked in fixed point (32 fractional bits), so that each row only needs integer arithmetic
+        constexpr double colUnit = 4294967296.0;
+        constexpr int64_t halfCol = int64_t{1} << 31;
+        // Squares the ray only grazes are left out, so diagonal rays do not clip their neighbours
+        constexpr int64_t edgeTolerance = static_cast<int64_t>(colUnit / 10000);
+        int64_t entryBias = 0;
+        int64_t exitBias = 0;
+        if (direction.x > 0)
+        {
+            entryBias = edgeTolerance;
+            exitBias = -edgeTolerance - 1;
+        }
+        else if (direction.x < 0)
+        {
+            entryBias = -edgeTolerance - 1;
+            exitBias = edgeTolerance;
+        }
+        const bool reverse = direction.x < 0;
+
+        double colsPerRow = 0;
+        if (direction.y != 0)
+        {
+            const double maxColsPerRow = 2.0 * (distance + 1);
+            colsPerRow = std::clamp<double>(direction.x / std::abs(direction.y), -maxColsPerRow, maxColsPerRow);
+        }
+        const int64_t crossingStep = static_cast<int64_t>(colsPerRow * colUnit);
+        const int64_t endCol = halfCol + static_cast<int64_t>(direction.x * distance * colUnit);
+        int64_t enterCol = halfCol;
+        int64_t crossingCol = halfCol + crossingStep / 2;
+        for (int row = currentRow;; row += rowStep)
+        {
+            const int firstCol = currentCol + static_cast<int>((enterCol + entryBias) >> 32);
+            const int64_t exitCol = row == lastRow ? endCol : crossingCol;
+            const int exit = currentCol + static_cast<int>((exitCol + exitBias) >> 32);
+            const int lastCol = reverse ? std::min(exit, firstCol) : std::max(exit, firstCol);
+
+            if (debugLines != nullptr)
+            {
+                const int colStep = reverse ? -1 : 1;
+                for (int col = firstCol;; col += colStep)
+                {
+                    const GridSquare square{row, col};
+                    debugLines->push_back(square);
+                    if (CheckWithinGridBounds(square))
+                    {
+                        gridDebug.Set(square, {true, PURPLE});
+                        if (const auto occupant = occupantAt(square, ignore); occupant != entt::null)
+                        {
+                            return occupant;
+                        }
+                    }
+                    if (col == lastCol) break;
+                }
+            }
+            else if (row >= 0 && row < slices)
+            {
+                // Occupied squares without an occupant (e.g., steep terrain) do not stop the ray
+                int minCol = std::max(std::min(firstCol, lastCol), 0);
+                int maxCol = std::min(std::max(firstCol, lastCol) + 1, slices);
+                while (true)
+                {
+                    const int col = occupancyBits.FindInRow(row, minCol, maxCol, reverse);
+                    if (col < 0) break;
+                    if (const auto occupant = occupantAt({row, col}, ignore); occupant != entt::null)
+                    {
+                        return occupant;
+                    }
+                    if (reverse)
+                    {
+                        maxCol = col;
+                    }
+                    else
+                    {
+                        minCol = col + 1;
+                    }
+                }
+            }
+
+            if (row == lastRow) break;
+            enterCol = crossingCol;
+            crossingCol += crossingStep;
+        }
+        return entt::null;
+    }
+
+    // Main thread only. Searches never check the start square, so an actor just inside an obstacle can walk out.
+    int32_t NavigationGridSystem::startLabel(const GridSquare start, const GridSquare extents) const
+    {
+        int32_t label = connectivityMap.GetLabel(start, extents);
+        for (const auto& [dirRow, dirCol] : DIRECTIONS)
+        {
+            if (label != ConnectivityMap::NO_LABEL) break;
+            label = connectivityMap.GetLabel({start.row + dirRow, start.col + dirCol}, extents);
+        }
+        return label;
+    }
+
+    // Main thread only. If the start cannot reach the finish, returns the nearest square it can reach.
+    GridSquare NavigationGridSystem::findReachableFinish(
+        const GridSquare start,
+        const GridSquare finish,
+        const GridSquare extents,
+        const GridSquare minRange,
+        const GridSquare maxRange) const
+    {
+        const int32_t label = startLabel(start, extents);
+        if (label == ConnectivityMap::NO_LABEL) return finish;
+        if (connectivityMap.GetLabel(finish, extents) == label && checkExtents(finish, extents)) return finish;
+
+        // Usually the nearest walkable square is also reachable, which saves scanning for one
+        if (const auto nearest = nearestWalkableMap.Find(finish, extents);
+            nearest && CheckWithinBounds(*nearest, minRange, maxRange) &&
+            connectivityMap.GetLabel(*nearest, extents) == label)
+        {
+            return *nearest;
+        }
+
+        const int maxRadius = std::max(
+            {finish.row - minRange.row,
+             maxRange.row - finish.row,
+             finish.col - minRange.col,
+             maxRange.col - finish.col});
+        GridSquare best = finish;
+        double bestDistance = std::numeric_limits<double>::max();
+
+        // A later ring can still hold a closer square than the corners of an earlier one
+        for (int radius = 1; radius <= maxRadius && radius < bestDistance; ++radius)
+        {
+            auto consider = [&](const GridSquare square) {
+                if (!CheckWithinBounds(square, minRange, maxRange) ||
+                    connectivityMap.GetLabel(square, extents) != label || !checkExtents(square, extents))
+                {
+                    return;
+                }
+                if (const double distance = octileDistance(square, finish); distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = square;
+                }
+            };
+
+            for (int col = finish.col - radius; col <= finish.col + radius; ++col)
+            {
+                consider({finish.row - radius, col});
+                consider({finish.row + radius, col});
+            }
+            for (int row = finish.row - radius + 1; row < finish.row + radius; ++row)
+            {
+                consider({row, finish.col - radius});
+                consider({row, finish.col + radius});
+            }
+        }
+
+        return best;
+    }
+
+    // Main thread only. Only false if the static grid walls the finish off from the start.
+    bool NavigationGridSystem::canReach(
+        const GridSquare start, const GridSquare finish, const GridSquare extents) const
+    {
+        const int32_t label = startLabel(start, extents);
+        return label == ConnectivityMap::NO_LABEL || connectivityMap.GetLabel(finish, extents) == label;
     }
 
     GridSquare NavigationGridSystem::FindNextBestLocation(entt::entity entity, GridSquare target) const
@@ -886,26 +1659,27 @@ namespace sage
         const GridSquare maxRange,
         const GridSquare extents) const
     {
-        struct Compare
+        // Worker threads read an occupancy snapshot, which the nearest walkable map does not describe
+        if (occupancyView.occupancy == nullptr)
         {
-            bool operator()(const std::pair<int, GridSquare>& a, const std::pair<int, GridSquare>& b) const
+            if (const auto nearest = nearestWalkableMap.Find(target, extents);
+                nearest && CheckWithinBounds(*nearest, minRange, maxRange))
             {
-                return a.first > b.first;
+                return *nearest;
             }
-        };
-        std::vector<std::vector<bool>> visited(maxRange.row, std::vector<bool>(maxRange.col, false));
-        std::priority_queue<std::pair<int, GridSquare>, std::vector<std::pair<int, GridSquare>>, Compare> frontier;
+        }
 
-        frontier.emplace(0, currentPos);
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
+
+        context.Push(0, currentPos);
 
         GridSquare bestSquare{};
         int bestScore = std::numeric_limits<int>::max();
 
-        while (!frontier.empty())
+        while (!context.HeapEmpty())
         {
-            auto currentPair = frontier.top();
-            frontier.pop();
-            auto current = currentPair.second;
+            const auto current = context.Pop().square;
 
             // Check if this is a valid and better square
             if (checkExtents(current, extents))
@@ -919,15 +1693,15 @@ namespace sage
                 }
             }
 
-            for (const auto& dir : directions)
+            for (const auto& dir : DIRECTIONS)
             {
                 GridSquare next = {current.row + dir.second, current.col + dir.first};
 
-                if (!CheckWithinBounds(next, minRange, maxRange) || visited[next.row][next.col]) continue;
+                if (!CheckWithinBounds(next, minRange, maxRange) || context.IsVisited(index(next))) continue;
 
-                visited[next.row][next.col] = true;
+                context.Visit(index(next), current);
                 int priority = heuristic(next, target) + heuristic(currentPos, next); // f = g + h
-                frontier.emplace(priority, next);
+                context.Push(priority, next);
             }
         }
 
@@ -945,7 +1719,7 @@ namespace sage
             startPos,
             finishPos,
             {0, 0},
-            {static_cast<int>(gridSquares.at(0).size()), static_cast<int>(gridSquares.size())},
+            {slices, slices},
             heuristicType);
     }
 
@@ -965,38 +1739,48 @@ namespace sage
             !getExtents(entity, extents))
             return {};
 
+        finishGridSquare = findReachableFinish(startGridSquare, finishGridSquare, extents, minRange, maxRange);
         if (!checkExtents(finishGridSquare, extents))
         {
-            // TODO: Should try to find next best location to "original" destination
             finishGridSquare =
                 FindNextBestLocation(startGridSquare, finishGridSquare, minRange, maxRange, extents);
         }
 
-        struct Compare
+        const PathCacheKey cacheKey{
+            finishGridSquare,
+            extents,
+            heuristicType == AStarHeuristic::JUMP_POINT_SEARCH ? PathSearchType::JUMP_POINT_SEARCH
+                                                               : PathSearchType::ASTAR};
+        if (std::vector<Vector3> cached; findCachedPath(cacheKey, startGridSquare, minRange, maxRange, cached))
         {
-            bool operator()(const std::pair<int, GridSquare>& a, const std::pair<int, GridSquare>& b) const
+            return cached;
+        }
+
+        if (heuristicType == AStarHeuristic::JUMP_POINT_SEARCH)
+        {
+            if (!jumpPointSearch(startGridSquare, finishGridSquare, extents, minRange, maxRange))
             {
-                return a.first > b.first;
+                return {};
             }
-        };
-
-        std::vector<std::vector<bool>> visited(maxRange.row, std::vector<bool>(maxRange.col, false));
-        std::vector<std::vector<GridSquare>> came_from(
-            maxRange.row, std::vector<GridSquare>(maxRange.col, {-1, -1}));
-        std::vector<std::vector<double>> cost_so_far(maxRange.row, std::vector<double>(maxRange.col, 0.0));
+            const auto& context = PathfindingContext::ThreadLocal();
+            pathCache.Insert(cacheKey, collectPath(context, startGridSquare, finishGridSquare));
+            return tracebackPath(context, startGridSquare, finishGridSquare, extents);
+        }
 
-        std::priority_queue<std::pair<int, GridSquare>, std::vector<std::pair<int, GridSquare>>, Compare> frontier;
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
 
-        frontier.emplace(0, startGridSquare);
-        visited[startGridSquare.row][startGridSquare.col] = true;
+        context.Push(octileDistance(startGridSquare, finishGridSquare), startGridSquare);
+        context.Visit(index(startGridSquare), {-1, -1});
 
         bool pathFound = false;
 
-        while (!frontier.empty())
+        while (!context.HeapEmpty())
         {
-            const auto currentPair = frontier.top();
-            frontier.pop();
-            const auto current = currentPair.second;
+            const auto [priority, current, cost] = context.Pop();
+
+            // Already expanded with a lower cost
+            if (cost > context.CostSoFar(index(current))) continue;
 
             if (current.row == finishGridSquare.row && current.col == finishGridSquare.col)
             {
@@ -1004,25 +1788,23 @@ namespace sage
                 break;
             }
 
-            for (const auto& [dirX, dirY] : directions)
+            for (const auto& [dirX, dirY] : DIRECTIONS)
             {
                 GridSquare next = {current.row + dirX, current.col + dirY};
+                if (!CheckWithinBounds(next, minRange, maxRange)) continue;
 
-                const auto current_cost = gridSquares[current.row][current.col]->pathfindingCost;
-                const auto next_cost = gridSquares[next.row][next.col]->pathfindingCost;
-                const double new_cost = current_cost + next_cost;
+                // Steps cost the square's pathfinding cost, scaled by sqrt(2) for diagonals. Pathfinding costs are
+                // at least 1, so the octile distance never overestimates and the first path found is the shortest.
+                const double stepCost =
+                    (dirX != 0 && dirY != 0 ? std::numbers::sqrt2 : 1.0) * gridPathfindingCost.Get(next);
+                const double new_cost = cost + stepCost;
 
-                if (CheckWithinBounds(next, minRange, maxRange) && checkExtents(next, extents) &&
-                    (!visited[next.row][next.col] ||
-                     (visited[next.row][next.col] && new_cost < cost_so_far[next.row][next.col])) &&
-                    !gridSquares.at(next.row).at(next.col)->occupied)
+                if (checkExtents(next, extents) &&
+                    (!context.IsVisited(index(next)) || new_cost < context.CostSoFar(index(next))) &&
+                    !isOccupied(next))
                 {
-                    cost_so_far[next.row][next.col] = new_cost;
-                    const double heuristic_cost = heuristic(next, finishGridSquare);
-                    const double priority = new_cost + heuristic_cost;
-                    frontier.emplace(priority, next);
-                    came_from[next.row][next.col] = current;
-                    visited[next.row][next.col] = true;
+                    context.Visit(index(next), current, new_cost);
+                    context.Push(new_cost + octileDistance(next, finishGridSquare), next, new_cost);
                 }
             }
         }
@@ -1032,7 +1814,228 @@ namespace sage
             return {};
         }
 
-        return tracebackPath(came_from, startGridSquare, finishGridSquare);
+        pathCache.Insert(cacheKey, collectPath(context, startGridSquare, finishGridSquare));
+        return tracebackPath(context, startGridSquare, finishGridSquare, extents);
+    }
+
+    // Not limited to a pathfinding range. Routes are close to, but not always, the shortest.
+    std::vector<Vector3> NavigationGridSystem::HierarchicalPathfind(
+        const entt::entity& entity, const Vector3& startPos, const Vector3& finishPos) const
+    {
+        GridSquare startGridSquare{};
+        GridSquare finishGridSquare{};
+        GridSquare extents{};
+
+        if (!WorldToGridSpace(startPos, startGridSquare) || !WorldToGridSpace(finishPos, finishGridSquare) ||
+            !getExtents(entity, extents))
+            return {};
+
+        finishGridSquare =
+            findReachableFinish(startGridSquare, finishGridSquare, extents, {0, 0}, {slices, slices});
+        // Nothing reachable, so a search could only fail after visiting the start's whole component
+        if (!canReach(startGridSquare, finishGridSquare, extents)) return {};
+        if (!checkExtents(finishGridSquare, extents))
+        {
+            finishGridSquare =
+                FindNextBestLocation(startGridSquare, finishGridSquare, {0, 0}, {slices, slices}, extents);
+        }
+
+        const PathCacheKey cacheKey{finishGridSquare, extents, PathSearchType::HIERARCHICAL};
+        if (std::vector<Vector3> cached;
+            findCachedPath(cacheKey, startGridSquare, {0, 0}, {slices, slices}, cached))
+        {
+            return cached;
+        }
+
+        std::vector<GridSquare> squares;
+        if (!hierarchicalGrid.FindPath(
+                *hierarchicalGrid.GetGraph(extents), startGridSquare, finishGridSquare, extents, squares))
+        {
+            return {};
+        }
+
+        auto path = tracebackPath(squares, extents);
+        pathCache.Insert(cacheKey, std::move(squares));
+        return path;
+    }
+
+    // False if the actor cannot get any closer to the target
+    bool NavigationGridSystem::FlowFieldNextStep(
+        const entt::entity& entity, const Vector3& startPos, const entt::entity target, Vector3& next) const
+    {
+        constexpr size_t maxCachedFields = 32;
+
+        GridSquare startGridSquare{};
+        GridSquare goalGridSquare{};
+        GridSquare extents{};
+
+        if (!WorldToGridSpace(startPos, startGridSquare) ||
+            !WorldToGridSpace(registry->get<sgTransform>(target).GetWorldPos(), goalGridSquare) ||
+            !getExtents(entity, extents))
+            return false;
+
+        const FlowFieldKey key{target, extents};
+        if (const auto it = flowFieldLookup.find(key); it != flowFieldLookup.end())
+        {
+            flowFields.splice(flowFields.begin(), flowFields, it->second);
+        }
+        else
+        {
+            if (flowFields.size() >= maxCachedFields)
+            {
+                flowFieldLookup.erase(flowFields.back().first);
+                flowFields.pop_back();
+            }
+            flowFields.emplace_front(key, FlowField{});
+            flowFieldLookup[key] = flowFields.begin();
+        }
+
+        auto& field = flowFields.front().second;
+        if (!field.IsValid(goalGridSquare, staticOccupancyVersion))
+        {
+            field.Build(*this, goalGridSquare, extents, staticOccupancyVersion);
+        }
+
+        // The field runs right up to the target, stop at the last square that is actually free
+        GridSquare nextGridSquare{};
+        if (!field.NextSquare(startGridSquare, nextGridSquare) ||
+            !isWalkable(nextGridSquare, extents, {0, 0}, {slices, slices}))
+        {
+            return false;
+        }
+
+        next = getWorldPosMin(nextGridSquare.row, nextGridSquare.col);
+        next.y = terrain.GetHeight(nextGridSquare);
+        return true;
+    }
+
+    // The planner is reset if the destination or extents changed, or the actor left its range
+    std::vector<Vector3> NavigationGridSystem::IncrementalPathfind(
+        const entt::entity& entity,
+        IncrementalPlanner& planner,
+        const Vector3& startPos,
+        const Vector3& finishPos,
+        const GridSquare& minRange,
+        const GridSquare& maxRange) const
+    {
+        GridSquare start{};
+        GridSquare finish{};
+        GridSquare extents{};
+        if (!WorldToGridSpace(startPos, start) || !WorldToGridSpace(finishPos, finish) ||
+            !getExtents(entity, extents))
+            return {};
+
+        finish = findReachableFinish(start, finish, extents, minRange, maxRange);
+        if (!checkExtents(finish, extents))
+        {
+            finish = FindNextBestLocation(start, finish, minRange, maxRange, extents);
+        }
+
+        if (!planner.CanReplan(start, finish, extents))
+        {
+            planner.Init(*this, start, finish, extents, minRange, maxRange);
+        }
+
+        std::vector<GridSquare> squares;
+        if (!planner.Replan(*this, start, squares))
+        {
+            return {};
+        }
+
+        return tracebackPath(squares, extents);
+    }
+
+    // Every step of the window is a waypoint. A repeated waypoint is a step spent waiting.
+    std::vector<Vector3> NavigationGridSystem::CooperativePathfind(
+        const entt::entity& entity,
+        CooperativePlanner& planner,
+        const Vector3& startPos,
+        const Vector3& finishPos,
+        const int startStep) const
+    {
+        GridSquare start{};
+        GridSquare finish{};
+        GridSquare extents{};
+        if (!WorldToGridSpace(startPos, start) || !WorldToGridSpace(finishPos, finish) ||
+            !getExtents(entity, extents))
+            return {};
+
+        finish = findReachableFinish(start, finish, extents, {0, 0}, {slices, slices});
+        if (!canReach(start, finish, extents))
+        {
+            planner.Release(entity);
+            return {};
+        }
+        if (!checkExtents(finish, extents))
+        {
+            finish = FindNextBestLocation(start, finish, {0, 0}, {slices, slices}, extents);
+        }
+        // Others in the group may already be headed for the same place
+        finish = planner.FindFreeGoal(*this, entity, finish, extents);
+
+        std::vector<GridSquare> steps;
+        std::vector<GridSquare> rest;
+        if (!planner.Plan(*this, entity, start, finish, extents, startStep, steps) &&
+            !hierarchicalGrid.FindPath(*hierarchicalGrid.GetGraph(extents), steps.back(), finish, extents, rest))
+        {
+            planner.Release(entity);
+            return {};
+        }
+        // Assumes the rest of the route takes a step per square as well
+        const auto arrival = startStep + static_cast<int>(steps.size() + std::max<size_t>(rest.size(), 1)) - 2;
+        planner.Park(entity, finish, extents, arrival);
+
+        auto combineWorldPosTerrainHeight = [this](const GridSquare gridPos) {
+            Vector3 worldPos = getWorldPosMin(gridPos.row, gridPos.col);
+            worldPos.y = terrain.GetHeight(gridPos);
+            return worldPos;
+        };
+
+        // As with tracebackPath, the start is left out, unless the actor has to wait there or stay put
+        const bool keepStart = steps.size() > 1 ? steps[1] == steps[0] : rest.size() < 2;
+        std::vector<Vector3> path;
+        for (size_t i = keepStart ? 0 : 1; i < steps.size(); ++i)
+        {
+            path.push_back(combineWorldPosTerrainHeight(steps[i]));
+        }
+        if (rest.size() > 1)
+        {
+            const auto tail = tracebackPath(rest, extents);
+            path.insert(path.end(), tail.begin(), tail.end());
+        }
+        return path;
+    }
+
+    // For actors outside the group (e.g., the leader), assuming a square per step
+    void NavigationGridSystem::ReserveRoute(
+        const entt::entity& entity,
+        CooperativePlanner& planner,
+        const Vector3& startPos,
+        const std::deque<Vector3>& path,
+        const int startStep) const
+    {
+        GridSquare square{};
+        GridSquare extents{};
+        if (!WorldToGridSpace(startPos, square) || !getExtents(entity, extents)) return;
+
+        std::vector<GridSquare> squares{square};
+        for (const auto& waypoint : path)
+        {
+            GridSquare next{};
+            if (!WorldToGridSpace(waypoint, next)) break;
+            while (square != next && squares.size() <= CooperativePlanner::WINDOW)
+            {
+                square.row += (next.row > square.row) - (next.row < square.row);
+                square.col += (next.col > square.col) - (next.col < square.col);
+                squares.push_back(square);
+            }
+        }
+        planner.Reserve(entity, squares, extents, startStep);
+        // Only an actor that stops within the window keeps its square
+        if (squares.size() <= CooperativePlanner::WINDOW)
+        {
+            planner.Park(entity, squares.back(), extents, startStep + static_cast<int>(squares.size()) - 1);
+        }
     }
 
     /**
@@ -1049,7 +2052,7 @@ namespace sage
             startPos,
             finishPos,
             {0, 0},
-            {static_cast<int>(gridSquares.at(0).size()), static_cast<int>(gridSquares.size())});
+            {slices, slices});
     }
 
     /**
@@ -1075,28 +2078,46 @@ namespace sage
             !getExtents(entity, extents))
             return {};
 
+        finish = findReachableFinish(start, finish, extents, minRange, maxRange);
         if (!checkExtents(finish, extents))
         {
-            // TODO: Should actually try to find next best location to original
-            // destination
             finish = FindNextBestLocation(start, finish, minRange, maxRange, extents);
         }
 
-        std::vector<std::vector<bool>> visited(maxRange.row, std::vector<bool>(maxRange.col, false));
-        std::vector<std::vector<GridSquare>> came_from(
-            maxRange.row, std::vector<GridSquare>(maxRange.col, {-1, -1}));
+        const PathCacheKey cacheKey{finish, extents, PathSearchType::BFS};
+        if (std::vector<Vector3> cached; findCachedPath(cacheKey, start, minRange, maxRange, cached))
+        {
+            return cached;
+        }
+
+        if (!breadthFirstSearch(start, finish, extents, minRange, maxRange))
+        {
+            return {};
+        }
 
-        std::queue<GridSquare> frontier;
+        const auto& context = PathfindingContext::ThreadLocal();
+        pathCache.Insert(cacheKey, collectPath(context, start, finish));
+        return tracebackPath(context, start, finish, extents);
+    }
 
-        frontier.emplace(start);
-        visited[start.row][start.col] = true;
+    bool NavigationGridSystem::breadthFirstSearch(
+        const GridSquare& start,
+        const GridSquare& finish,
+        const GridSquare& extents,
+        const GridSquare& minRange,
+        const GridSquare& maxRange) const
+    {
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
+
+        context.Enqueue(start);
+        context.Visit(index(start), {-1, -1});
 
         bool pathFound = false;
 
-        while (!frontier.empty())
+        while (!context.QueueEmpty())
         {
-            const auto current = frontier.front();
-            frontier.pop();
+            const auto current = context.Dequeue();
 
             if (current.row == finish.row && current.col == finish.col)
             {
@@ -1104,30 +2125,144 @@ namespace sage
                 break;
             }
 
-            for (const auto& [dirX, dirY] : directions)
+            for (const auto& [dirX, dirY] : DIRECTIONS)
             {
                 if (GridSquare next = {current.row + dirX, current.col + dirY};
-                    CheckWithinBounds(next, minRange, maxRange) && !visited[next.row][next.col] &&
-                    checkExtents(next, extents) && !gridSquares[next.row][next.col]->occupied)
+                    CheckWithinBounds(next, minRange, maxRange) && !context.IsVisited(index(next)) &&
+                    checkExtents(next, extents) && !isOccupied(next))
                 {
-                    frontier.emplace(next);
-                    visited[next.row][next.col] = true;
-                    came_from[next.row][next.col] = current;
+                    context.Enqueue(next);
+                    context.Visit(index(next), current);
                 }
             }
         }
 
-        if (!pathFound)
+        return pathFound;
+    }
+
+    // Main thread only. The caller fills in the entity and destination.
+    bool NavigationGridSystem::PreparePathfindJob(
+        const entt::entity& entity,
+        const Vector3& startPos,
+        const Vector3& finishPos,
+        const GridSquare& minRange,
+        const GridSquare& maxRange,
+        const bool astar,
+        PathfindJob& job) const
+    {
+        if (!WorldToGridSpace(startPos, job.start) || !WorldToGridSpace(finishPos, job.finish) ||
+            !getExtents(entity, job.extents))
+            return false;
+
+        job.minRange = minRange;
+        job.maxRange = maxRange;
+        job.astar = astar;
+        if (astar)
         {
-            return {};
+            job.graph = hierarchicalGrid.GetGraph(job.extents);
         }
+        // Workers cannot read the connectivity labels, so unreachable destinations are dealt with here
+        job.finish = findReachableFinish(job.start, job.finish, job.extents, minRange, maxRange);
+        if (astar && !canReach(job.start, job.finish, job.extents)) return false;
+
+        // Squares the actor occupies itself, to be ignored by the search (see MarkSquareAreaOccupied)
+        const auto& bb = registry->get<Collideable>(entity).worldBoundingBox;
+        GridSquare a{};
+        GridSquare b{};
+        if (WorldToGridSpace(bb.min, a) && WorldToGridSpace(bb.max, b))
+        {
+            job.ignoreMin = {std::min(a.row, b.row), std::min(a.col, b.col)};
+            job.ignoreMax = {std::max(a.row, b.row), std::max(a.col, b.col)};
+        }
+        else
+        {
+            job.ignoreMin = {0, 0};
+            job.ignoreMax = {-1, -1};
+        }
+
+        return true;
+    }
 
-        return tracebackPath(came_from, start, finish);
+    // Safe to call from worker threads
+    std::vector<Vector3> NavigationGridSystem::RunPathfindJob(
+        const PathfindJob& job, const OccupancySnapshot& occupancy) const
+    {
+        occupancyView = {&occupancy, job.ignoreMin, job.ignoreMax};
+
+        auto finish = job.finish;
+        if (!checkExtents(finish, job.extents))
+        {
+            finish = FindNextBestLocation(job.start, finish, job.minRange, job.maxRange, job.extents);
+        }
+
+        std::vector<Vector3> path;
+        if (job.astar)
+        {
+            if (std::vector<GridSquare> squares;
+                hierarchicalGrid.FindPath(*job.graph, job.start, finish, job.extents, squares))
+            {
+                path = tracebackPath(squares, job.extents);
+            }
+        }
+        else if (breadthFirstSearch(job.start, finish, job.extents, job.minRange, job.maxRange))
+        {
+            path = tracebackPath(PathfindingContext::ThreadLocal(), job.start, finish, job.extents);
+        }
+
+        occupancyView = {};
+        return path;
+    }
+
+    // Reuses the last snapshot if the grid is unchanged and it covers the range
+    std::shared_ptr<const OccupancySnapshot> NavigationGridSystem::SnapshotOccupancy(
+        GridSquare minRange, GridSquare maxRange) const
+    {
+        minRange = {std::max(minRange.row, 0), std::max(minRange.col, 0)};
+        maxRange = {std::min(maxRange.row, slices), std::min(maxRange.col, slices)};
+        if (occupancySnapshot && occupancySnapshot->version == occupancyVersion &&
+            minRange.row >= occupancySnapshot->min.row && minRange.col >= occupancySnapshot->min.col &&
+            maxRange.row <= occupancySnapshot->max.row && maxRange.col <= occupancySnapshot->max.col)
+        {
+            return occupancySnapshot;
+        }
+
+        auto snapshot = std::make_shared<OccupancySnapshot>();
+        snapshot->min = minRange;
+        snapshot->max = maxRange;
+        snapshot->version = occupancyVersion;
+        snapshot->occupancy = gridOccupied.CopyRange(minRange, maxRange);
+
+        occupancySnapshot = snapshot;
+        return snapshot;
+    }
+
+    const PathCacheStats& NavigationGridSystem::GetPathCacheStats() const
+    {
+        return pathCache.GetStats();
+    }
+
+    uint64_t NavigationGridSystem::GetOccupancyChangeCount() const
+    {
+        return occupancyChangesDropped + occupancyChanges.size();
+    }
+
+    bool NavigationGridSystem::GetOccupancyChangesSince(
+        const uint64_t count, std::span<const OccupancyChange>& changes) const
+    {
+        if (count < occupancyChangesDropped) return false;
+        changes = std::span(occupancyChanges).subspan(static_cast<size_t>(count - occupancyChangesDropped));
+        return true;
     }
 
+    // Bakes in bands of rows across a thread pool, each band visiting floors in the same order
     void NavigationGridSystem::InitGridHeightAndNormals()
     {
         std::cout << "START: Initialising grid height and normals \n";
+        std::vector<TerrainSource> sources;
+        // One model per complex floor mesh, to build the mesh's BVH from. Instances of a model share the mesh.
+        std::unordered_map<const float*, const ModelSafe*> complexMeshes;
+        std::vector<const ModelSafe*> sourceModels; // Alongside sources
+
         const auto& view = registry->view<Collideable, Renderable>();
         for (const auto& entity : view)
         {
@@ -1136,30 +2271,107 @@ namespace sage
             if (bb.collisionLayer == CollisionLayer::FLOORCOMPLEX ||
                 bb.collisionLayer == CollisionLayer::FLOORSIMPLE || bb.collisionLayer == CollisionLayer::STAIRS)
             {
-                calculateTerrainHeightAndNormals(entity);
+                TerrainSource source{.layer = bb.collisionLayer, .area = bb.worldBoundingBox, .squares = {}};
+                if (!getFootprint(bb.worldBoundingBox, source.squares)) continue;
+
+                const ModelSafe* model = nullptr;
+                if (bb.collisionLayer == CollisionLayer::FLOORCOMPLEX)
+                {
+                    model = view.get<Renderable>(entity).GetModel();
+                    complexMeshes.try_emplace(model->GetMesh(0).vertices, model);
+                    source.transform =
+                        MatrixMultiply(model->GetTransform(), registry->get<sgTransform>(entity).GetMatrix());
+                }
+                sources.push_back(source);
+                sourceModels.push_back(model);
             }
         }
+
+        const unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        auto runOnPool = [threadCount](const size_t taskCount, const auto& task) {
+            std::atomic<size_t> next = 0;
+            auto work = [&next, taskCount, &task] {
+                for (size_t i = next++; i < taskCount; i = next++)
+                {
+                    task(i);
+                }
+            };
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < std::min<size_t>(threadCount, taskCount); ++i)
+            {
+                threads.emplace_back(work);
+            }
+            work();
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        };
+
+        // The BVHs are kept by the ResourceManager, so later ray casts (e.g., the cursor) reuse them
+        std::vector<const ModelSafe*> meshModels;
+        for (const auto& [vertices, model] : complexMeshes)
+        {
+            meshModels.push_back(model);
+        }
+        runOnPool(meshModels.size(), [&meshModels](const size_t i) { (void)meshModels[i]->GetMeshBvh(0); });
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            if (sourceModels[i]) sources[i].bvh = &sourceModels[i]->GetMeshBvh(0);
+        }
+
+        // Allocated up front, as chunks are not loaded from more than one thread at a time
+        terrain.LoadAll();
+        constexpr int ROWS_PER_TASK = 8;
+        runOnPool((slices + ROWS_PER_TASK - 1) / ROWS_PER_TASK, [this, &sources](const size_t task) {
+            const int firstRow = static_cast<int>(task) * ROWS_PER_TASK;
+            const int lastRow = std::min(firstRow + ROWS_PER_TASK, slices) - 1;
+            for (const auto& source : sources)
+            {
+                if (source.squares.max.row < firstRow || source.squares.min.row > lastRow) continue;
+                calculateTerrainHeightAndNormals(source, firstRow, lastRow);
+            }
+        });
+
+        std::cout << "Baked " << sources.size() << " floors (" << complexMeshes.size() << " complex meshes) on "
+                  << threadCount << " threads \n";
         std::cout << "FINISH: Initialising grid height and normals \n";
     }
 
     /*
      * This function finds the collisions between buildings in the world and the grid
      * squares and marks them as occupied.
+     * Fallback for maps packed without a Heightfield.
      */
     void NavigationGridSystem::PopulateGrid(const ImageSafe& heightMap, const ImageSafe& normalMap)
     {
-        for (auto& row : gridSquares)
-        {
-            for (auto& gridSquare : row)
-            {
-                gridSquare->occupied = false;
-            }
-        }
-
-        const auto& view = registry->view<Collideable, Renderable>();
         // Load from image data
         loadTerrainNormalMap(normalMap);
         loadTerrainHeightMap(heightMap);
+        populateGrid();
+    }
+
+    void NavigationGridSystem::PopulateGrid(const Heightfield& heightfield)
+    {
+        assert(heightfield.slices == slices);
+        terrain.SetSource(heightfield);
+        populateGrid();
+    }
+
+    void NavigationGridSystem::populateGrid()
+    {
+        gridStaticOccupied.Clear();
+        gridStaticOccupant.Clear();
+        gridOccupied.Clear();
+        occupancyBits.Clear();
+        ++occupancyVersion;
+        recordOccupancyChange({0, 0}, {slices - 1, slices - 1});
+        gridDynamicCount.ForEachChanged([this](const GridSquare square, uint8_t) {
+            gridOccupied.Set(square, true);
+            occupancyBits.Set(square, true);
+        });
+
+        const auto& view = registry->view<Collideable, Renderable>();
 
         std::cout << "START: Populating grid. \n";
         for (const auto& entity : view)
@@ -1186,18 +2398,71 @@ namespace sage
         std::cout << "FINISH: Populating grid. \n";
     }
 
-    const std::vector<std::vector<std::unique_ptr<NavigationGridSquare>>>& NavigationGridSystem::GetGridSquares()
+    // NB: Allocates the entire grid
+    std::vector<std::vector<NavigationGridSquare>> NavigationGridSystem::GetGridSquares() const
     {
-        return gridSquares;
+        std::vector<std::vector<NavigationGridSquare>> out(slices);
+        for (int row = 0; row < slices; ++row)
+        {
+            out[row].reserve(slices);
+            for (int col = 0; col < slices; ++col)
+            {
+                out[row].push_back(GetGridSquare(row, col));
+            }
+        }
+        return out;
+    }
+
+    NavigationGridSquare NavigationGridSystem::GetGridSquare(int row, int col) const
+    {
+        NavigationGridSquare square;
+        square.terrainHeight = terrain.GetHeight({row, col});
+        square.pathfindingCost = gridPathfindingCost.Get({row, col});
+        square.gridSquareIndex = {row, col};
+        square.worldPosMin = getWorldPosMin(row, col);
+        square.worldPosMax = {square.worldPosMin.x + spacing, 1.0f, square.worldPosMin.z + spacing};
+        square.worldPosCentre = {
+            square.worldPosMin.x + spacing * 0.5f, 0.5f, square.worldPosMin.z + spacing * 0.5f};
+        square.occupant = occupantAt({row, col});
+        square.occupied = gridOccupied.Get({row, col});
+        square.terrainNormal = terrain.GetNormal({row, col});
+        return square;
+    }
+
+    float NavigationGridSystem::GetTerrainHeight(GridSquare square) const
+    {
+        const auto height = terrain.GetHeight(square);
+        assert(height != NAVIGATION_GRID_NO_HEIGHT);
+        return height;
+    }
+
+    Vector3 NavigationGridSystem::GetTerrainNormal(GridSquare square) const
+    {
+        return terrain.GetNormal(square);
     }
 
-    const NavigationGridSquare* NavigationGridSystem::GetGridSquare(int row, int col) const
+    // Keeps terrain heights and normals unpacked near the camera and moving actors. Does nothing unless the grid
+    // was populated from a Heightfield.
+    void NavigationGridSystem::StreamTerrain(const Vector3 viewTarget)
     {
-        return gridSquares[row][col].get();
+        streamFocus.clear();
+        GridSquare square{};
+        if (WorldToGridSpace(viewTarget, square)) streamFocus.push_back(square);
+        for (const auto& [entity, moveable, transform] : registry->view<MoveableActor, sgTransform>().each())
+        {
+            if (!moveable.IsMoving()) continue;
+            if (WorldToGridSpace(transform.GetWorldPos(), square)) streamFocus.push_back(square);
+            if (WorldToGridSpace(moveable.GetDestination(), square)) streamFocus.push_back(square);
+        }
+        terrain.KeepLoaded(streamFocus, TERRAIN_STREAM_RADIUS);
     }
 
     NavigationGridSystem::NavigationGridSystem(entt::registry* _registry, CollisionSystem* _collisionSystem)
-        : BaseSystem(_registry), collisionSystem(_collisionSystem)
+        : BaseSystem(_registry),
+          collisionSystem(_collisionSystem),
+          connectivityMap(this),
+          nearestWalkableMap(this),
+          hierarchicalGrid(this)
     {
     }
 } // namespace sage
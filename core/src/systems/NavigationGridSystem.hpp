@@ -5,42 +5,207 @@
 #include "slib.hpp"
 
 #include "components/NavigationGridSquare.hpp"
+#include "navigation/ChunkedLayer.hpp"
+#include "navigation/ClearanceMap.hpp"
+#include "navigation/ConnectivityMap.hpp"
+#include "navigation/CooperativePlanner.hpp"
+#include "navigation/FlowField.hpp"
+#include "navigation/Heightfield.hpp"
+#include "navigation/HierarchicalGrid.hpp"
+#include "navigation/IncrementalPlanner.hpp"
+#include "navigation/NavigationGridView.hpp"
+#include "navigation/NearestWalkableMap.hpp"
+#include "navigation/OccupancyBitset.hpp"
+#include "navigation/PathCache.hpp"
+#include "navigation/TerrainChunks.hpp"
 
 #include "entt/entt.hpp"
 #include "raylib.h"
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace sage
 {
     class CollisionSystem;
+    class PathfindingContext;
     struct GridSquare;
+    struct OccupancySnapshot;
+    struct PathfindJob;
 
     enum class AStarHeuristic
     {
         DEFAULT,
-        FAVOUR_RIGHT
+        FAVOUR_RIGHT,
+        JUMP_POINT_SEARCH // Jump point search. Assumes a uniform cost grid (ignores pathfindingCost).
     };
 
-    class NavigationGridSystem : public BaseSystem
+    class NavigationGridSystem final : public BaseSystem, public NavigationGridView
     {
-        std::vector<std::pair<int, int>> directions = {
-            {1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}};
+        // A rectangle of squares (inclusive)
+        struct Footprint
+        {
+            GridSquare min;
+            GridSquare max;
+
+            [[nodiscard]] bool Contains(const GridSquare square) const
+            {
+                return square.row >= min.row && square.row <= max.row && square.col >= min.col &&
+                       square.col <= max.col;
+            }
+            bool operator==(const Footprint&) const = default;
+        };
+
         CollisionSystem* collisionSystem;
-        std::vector<std::vector<std::unique_ptr<NavigationGridSquare>>> gridSquares;
 
+        // Chunks are only allocated where a square differs from the default (unoccupied, cost 1, no debug), so
+        // open ground costs nothing. gridOccupied is the union of the static layer (the map) and the dynamic layer
+        // (moving actors, applied in FlushDynamicOccupants).
+        ChunkedLayer<uint8_t> gridStaticOccupied;
+        ChunkedLayer<entt::entity> gridStaticOccupant;
+        ChunkedLayer<uint8_t> gridDynamicCount;
+        ChunkedLayer<entt::entity> gridDynamicOccupant; // One of the actors counted in gridDynamicCount
+        ChunkedLayer<uint8_t> gridOccupied;
+        ChunkedLayer<int> gridPathfindingCost;
+        // Only read when turning squares into waypoints. Loaded around the camera and actors (see StreamTerrain).
+        TerrainChunks terrain;
+        // Scratch for StreamTerrain
+        std::vector<GridSquare> streamFocus;
+        // gridOccupied packed one bit per square, for line of sight and CastRay
+        OccupancyBitset occupancyBits;
+        // Squares covered by each moving actor, as last applied to the dynamic layer
+        std::unordered_map<entt::entity, Footprint> dynamicFootprints;
+        // Actor positions queued since the last FlushDynamicOccupants, in the order they were queued
+        std::vector<std::pair<entt::entity, BoundingBox>> pendingOccupants;
+        mutable ChunkedLayer<NavigationGridSquareDebug> gridDebug;
+        // Built lazily, hence mutable
+        mutable ClearanceMap clearanceMap;
+        mutable ClearanceMap staticClearanceMap;
+        mutable ConnectivityMap connectivityMap;
+        mutable NearestWalkableMap nearestWalkableMap;
+        mutable HierarchicalGrid hierarchicalGrid;
+        uint32_t staticOccupancyVersion = 0;
+        uint32_t occupancyVersion = 0;
+        mutable std::shared_ptr<const OccupancySnapshot> occupancySnapshot;
+        // Oldest first, for IncrementalPlanner
+        std::vector<OccupancyChange> occupancyChanges;
+        uint64_t occupancyChangesDropped = 0;
+        // Most recently used first
+        using FlowFieldKey = std::pair<entt::entity, GridSquare>;
+        mutable std::list<std::pair<FlowFieldKey, FlowField>> flowFields;
+        mutable std::map<FlowFieldKey, std::list<std::pair<FlowFieldKey, FlowField>>::iterator> flowFieldLookup;
+        mutable PathCache pathCache;
+
+        //---------------------------------------------------------
+        [[nodiscard]] int index(const int row, const int col) const
+        {
+            return row * slices + col;
+        }
+        //---------------------------------------------------------
+        [[nodiscard]] int index(const GridSquare& square) const
+        {
+            return square.row * slices + square.col;
+        }
+        //---------------------------------------------------------
+        [[nodiscard]] Vector3 getWorldPosMin(int row, int col) const;
+        // Keeps the square's debug colour
+        void setDrawDebug(GridSquare square, bool drawDebug) const;
+
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<Vector3> tracebackPath(
+            const PathfindingContext& context,
+            const GridSquare& start,
+            const GridSquare& finish,
+            const GridSquare& extents) const;
         //---------------------------------------------------------
         [[nodiscard]] std::vector<Vector3> tracebackPath(
-            const std::vector<std::vector<GridSquare>>& came_from,
+            const std::vector<GridSquare>& squares, const GridSquare& extents) const;
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<GridSquare> stringPull(
+            const std::vector<GridSquare>& squares, const GridSquare& extents) const;
+        //---------------------------------------------------------
+        [[nodiscard]] bool hasLineOfSight(GridSquare from, GridSquare to, const GridSquare& extents) const;
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<GridSquare> collectPath(
+            const PathfindingContext& context, const GridSquare& start, const GridSquare& finish) const;
+        //---------------------------------------------------------
+        bool findCachedPath(
+            const PathCacheKey& key,
             const GridSquare& start,
-            const GridSquare& finish) const;
+            const GridSquare& minRange,
+            const GridSquare& maxRange,
+            std::vector<Vector3>& path) const;
+        //---------------------------------------------------------
+        [[nodiscard]] int32_t startLabel(GridSquare start, GridSquare extents) const;
+        //---------------------------------------------------------
+        [[nodiscard]] GridSquare findReachableFinish(
+            GridSquare start,
+            GridSquare finish,
+            GridSquare extents,
+            GridSquare minRange,
+            GridSquare maxRange) const;
+        //---------------------------------------------------------
+        [[nodiscard]] bool canReach(GridSquare start, GridSquare finish, GridSquare extents) const;
         //---------------------------------------------------------
         bool getExtents(entt::entity entity, GridSquare& extents) const;
         //---------------------------------------------------------
+        [[nodiscard]] bool isOccupied(GridSquare square) const;
+        //---------------------------------------------------------
         [[nodiscard]] bool checkExtents(GridSquare square, GridSquare extents) const;
         //---------------------------------------------------------
+        [[nodiscard]] bool isWalkable(
+            GridSquare square, GridSquare extents, GridSquare minRange, GridSquare maxRange) const;
+        //---------------------------------------------------------
+        [[nodiscard]] bool getFootprint(const BoundingBox& bb, Footprint& out) const;
+        //---------------------------------------------------------
+        bool setStaticSquare(GridSquare square, bool occupied, entt::entity occupant);
+        //---------------------------------------------------------
+        void markStaticChanged(GridSquare minSquare, GridSquare maxSquare);
+        void recordOccupancyChange(GridSquare minSquare, GridSquare maxSquare);
+        //---------------------------------------------------------
+        void applyDynamicFootprint(entt::entity entity, const Footprint& footprint, bool add);
+        //---------------------------------------------------------
+        [[nodiscard]] entt::entity findDynamicOccupant(GridSquare square, entt::entity ignore) const;
+        //---------------------------------------------------------
+        [[nodiscard]] entt::entity occupantAt(GridSquare square, entt::entity ignore = entt::null) const;
+        //---------------------------------------------------------
+        [[nodiscard]] bool isStaticallyWalkable(GridSquare square, GridSquare extents) const;
+        //---------------------------------------------------------
+        [[nodiscard]] bool jump(
+            GridSquare from,
+            GridSquare dir,
+            const GridSquare& finish,
+            const GridSquare& extents,
+            const GridSquare& minRange,
+            const GridSquare& maxRange,
+            GridSquare& out) const;
+        //---------------------------------------------------------
+        bool jumpPointSearch(
+            const GridSquare& start,
+            const GridSquare& finish,
+            const GridSquare& extents,
+            const GridSquare& minRange,
+            const GridSquare& maxRange) const;
+        //---------------------------------------------------------
+        bool breadthFirstSearch(
+            const GridSquare& start,
+            const GridSquare& finish,
+            const GridSquare& extents,
+            const GridSquare& minRange,
+            const GridSquare& maxRange) const;
+        //---------------------------------------------------------
         bool getExtents(Vector3 worldPos, GridSquare& extents) const;
         //---------------------------------------------------------
-        void calculateTerrainHeightAndNormals(const entt::entity& entity);
+        struct TerrainSource;
+        // Bakes the rows from firstRow to lastRow (inclusive) of the squares the source covers.
+        void calculateTerrainHeightAndNormals(const TerrainSource& source, int firstRow, int lastRow);
         //---------------------------------------------------------
         std::pair<float, float> getHeightBounds(float slices);
         //---------------------------------------------------------
@@ -48,8 +213,12 @@ namespace sage
         //---------------------------------------------------------
         void loadTerrainHeightMap(const ImageSafe& heightMap);
         //---------------------------------------------------------
+        void populateGrid();
+        //---------------------------------------------------------
 
       public:
+        // Chunks of terrain kept unpacked around the camera and each moving actor, in every direction
+        static constexpr int TERRAIN_STREAM_RADIUS = 1;
         float spacing{};
         int slices{};
 
@@ -62,8 +231,12 @@ namespace sage
         //---------------------------------------------------------
         void GenerateHeightMap(ImageSafe& image);
         //---------------------------------------------------------
+        void GenerateHeightfield(Heightfield& heightfield) const;
+        //---------------------------------------------------------
         void PopulateGrid(const ImageSafe& heightMap, const ImageSafe& normalMap);
         //---------------------------------------------------------
+        void PopulateGrid(const Heightfield& heightfield);
+        //---------------------------------------------------------
         bool GetPathfindRange(
             const entt::entity& actorId, int bounds, GridSquare& minRange, GridSquare& maxRange) const;
         //---------------------------------------------------------
@@ -87,12 +260,13 @@ namespace sage
             GridSquare maxRange,
             GridSquare extents) const;
         //---------------------------------------------------------
-        [[nodiscard]] NavigationGridSquare* CastRay(
+        [[nodiscard]] entt::entity CastRay(
             int currentRow,
             int currentCol,
             Vector2 direction,
             float distance,
-            std::vector<GridSquare>& debugLines) const;
+            entt::entity ignore = entt::null,
+            std::vector<GridSquare>* debugLines = nullptr) const;
         //---------------------------------------------------------
         [[nodiscard]] std::vector<Vector3> AStarPathfind(
             const entt::entity& entity,
@@ -108,6 +282,34 @@ namespace sage
             const GridSquare& maxRange,
             AStarHeuristic heuristicType = AStarHeuristic::DEFAULT) const;
         //---------------------------------------------------------
+        [[nodiscard]] std::vector<Vector3> HierarchicalPathfind(
+            const entt::entity& entity, const Vector3& startPos, const Vector3& finishPos) const;
+        //---------------------------------------------------------
+        bool FlowFieldNextStep(
+            const entt::entity& entity, const Vector3& startPos, entt::entity target, Vector3& next) const;
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<Vector3> IncrementalPathfind(
+            const entt::entity& entity,
+            IncrementalPlanner& planner,
+            const Vector3& startPos,
+            const Vector3& finishPos,
+            const GridSquare& minRange,
+            const GridSquare& maxRange) const;
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<Vector3> CooperativePathfind(
+            const entt::entity& entity,
+            CooperativePlanner& planner,
+            const Vector3& startPos,
+            const Vector3& finishPos,
+            int startStep) const;
+        //---------------------------------------------------------
+        void ReserveRoute(
+            const entt::entity& entity,
+            CooperativePlanner& planner,
+            const Vector3& startPos,
+            const std::deque<Vector3>& path,
+            int startStep) const;
+        //---------------------------------------------------------
         [[nodiscard]] std::vector<Vector3> BFSPathfind(
             const entt::entity& entity, const Vector3& startPos, const Vector3& finishPos) const;
         //---------------------------------------------------------
@@ -118,18 +320,95 @@ namespace sage
             const GridSquare& minRange,
             const GridSquare& maxRange) const;
         //---------------------------------------------------------
-        const std::vector<std::vector<std::unique_ptr<NavigationGridSquare>>>& GetGridSquares();
+        [[nodiscard]] std::vector<Vector3> CurvePath(
+            const entt::entity& entity,
+            const Vector3& startPos,
+            const std::vector<Vector3>& path,
+            float sampleSpacing) const;
         //---------------------------------------------------------
-        [[nodiscard]] const NavigationGridSquare* GetGridSquare(int row, int col) const;
+        [[nodiscard]] bool PreparePathfindJob(
+            const entt::entity& entity,
+            const Vector3& startPos,
+            const Vector3& finishPos,
+            const GridSquare& minRange,
+            const GridSquare& maxRange,
+            bool astar,
+            PathfindJob& job) const;
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<Vector3> RunPathfindJob(
+            const PathfindJob& job, const OccupancySnapshot& occupancy) const;
+        //---------------------------------------------------------
+        [[nodiscard]] std::shared_ptr<const OccupancySnapshot> SnapshotOccupancy(
+            GridSquare minRange, GridSquare maxRange) const;
+        //---------------------------------------------------------
+        [[nodiscard]] const PathCacheStats& GetPathCacheStats() const;
+        //---------------------------------------------------------
+        [[nodiscard]] uint64_t GetOccupancyChangeCount() const override;
+        //---------------------------------------------------------
+        [[nodiscard]] bool GetOccupancyChangesSince(
+            uint64_t count, std::span<const OccupancyChange>& changes) const override;
+        //---------------------------------------------------------
+        [[nodiscard]] int GetSlices() const override
+        {
+            return slices;
+        }
+        //---------------------------------------------------------
+        [[nodiscard]] bool IsOccupied(const GridSquare square) const override
+        {
+            return isOccupied(square);
+        }
+        //---------------------------------------------------------
+        [[nodiscard]] bool IsWalkable(
+            const GridSquare square,
+            const GridSquare extents,
+            const GridSquare minRange,
+            const GridSquare maxRange) const override
+        {
+            return isWalkable(square, extents, minRange, maxRange);
+        }
+        //---------------------------------------------------------
+        [[nodiscard]] bool IsStaticallyWalkable(const GridSquare square, const GridSquare extents) const override
+        {
+            return isStaticallyWalkable(square, extents);
+        }
+        //---------------------------------------------------------
+        bool JumpPointSearch(
+            const GridSquare start,
+            const GridSquare finish,
+            const GridSquare extents,
+            const GridSquare minRange,
+            const GridSquare maxRange) const override
+        {
+            return jumpPointSearch(start, finish, extents, minRange, maxRange);
+        }
+        //---------------------------------------------------------
+        [[nodiscard]] std::vector<std::vector<NavigationGridSquare>> GetGridSquares() const;
+        //---------------------------------------------------------
+        [[nodiscard]] NavigationGridSquare GetGridSquare(int row, int col) const;
+        //---------------------------------------------------------
+        [[nodiscard]] float GetTerrainHeight(GridSquare square) const;
+        //---------------------------------------------------------
+        [[nodiscard]] Vector3 GetTerrainNormal(GridSquare square) const;
+        //---------------------------------------------------------
+        void StreamTerrain(Vector3 viewTarget);
         //---------------------------------------------------------
         void DrawDebugPathfinding(const GridSquare& minRange, const GridSquare& maxRange) const;
         //---------------------------------------------------------
         void MarkSquareAreaOccupiedIfSteep(const BoundingBox& occupant, bool occupied);
         //---------------------------------------------------------
         void MarkSquareAreaOccupied(
-            const BoundingBox& occupant, bool occupied, entt::entity occupantEntity = entt::null) const;
+            const BoundingBox& occupant, bool occupied, entt::entity occupantEntity = entt::null);
+        //---------------------------------------------------------
+        void RemoveStaticOccupant(entt::entity entity, const BoundingBox& occupant);
+        void MarkSquaresOccupied(const std::vector<GridSquare>& squares, bool occupied = true);
+        //---------------------------------------------------------
+        void QueueDynamicOccupant(entt::entity entity, const BoundingBox& bb);
+        //---------------------------------------------------------
+        void FlushDynamicOccupants();
+        //---------------------------------------------------------
+        void PlaceDynamicOccupant(entt::entity entity, const BoundingBox& bb);
         //---------------------------------------------------------
-        void MarkSquaresOccupied(const std::vector<GridSquare>& squares, bool occupied = true) const;
+        void RemoveDynamicOccupant(entt::entity entity);
         //---------------------------------------------------------
         void MarkSquaresDebug(const std::vector<GridSquare>& squares, Color color, bool occupied = true) const;
         //---------------------------------------------------------
@@ -139,15 +418,17 @@ namespace sage
         //---------------------------------------------------------
         [[nodiscard]] bool CheckWithinBounds(Vector3 worldPos, GridSquare minRange, GridSquare maxRange) const;
         //---------------------------------------------------------
-        [[nodiscard]] static bool CheckWithinBounds(GridSquare square, GridSquare minRange, GridSquare maxRange);
+        using NavigationGridView::CheckWithinBounds;
         //---------------------------------------------------------
         [[nodiscard]] bool CheckSingleSquareOccupied(Vector3 worldPos) const;
         //---------------------------------------------------------
         [[nodiscard]] bool CheckSingleSquareOccupied(GridSquare position) const;
         //---------------------------------------------------------
-        [[nodiscard]] bool CheckBoundingBoxAreaUnoccupied(Vector3 worldPos, const BoundingBox& bb) const;
+        [[nodiscard]] bool CheckBoundingBoxAreaUnoccupied(
+            Vector3 worldPos, const BoundingBox& bb, entt::entity ignore = entt::null) const;
         //---------------------------------------------------------
-        [[nodiscard]] bool CheckBoundingBoxAreaUnoccupied(GridSquare square, const BoundingBox& bb) const;
+        [[nodiscard]] bool CheckBoundingBoxAreaUnoccupied(
+            GridSquare square, const BoundingBox& bb, entt::entity ignore = entt::null) const;
         //---------------------------------------------------------
         [[nodiscard]] entt::entity CheckSingleSquareOccupant(Vector3 worldPos) const;
         //---------------------------------------------------------
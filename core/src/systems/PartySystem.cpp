@@ -12,6 +12,7 @@
 #include "components/MoveableActor.hpp"
 #include "components/PartyMemberComponent.hpp"
 #include "components/States.hpp"
+#include "CollisionSystem.hpp"
 #include "ControllableActorSystem.hpp"
 #include "Cursor.hpp"
 #include "InventorySystem.hpp"
@@ -124,6 +125,7 @@ namespace sage
         combatable.actorType = CombatableActorType::PLAYER;
         auto& col = registry->get<Collideable>(npc);
         col.collisionLayer = CollisionLayer::PLAYER;
+        sys->collisionSystem->UpdateCollideable(npc);
         registry->emplace<PartyMemberComponent>(npc, npc);
         registry->emplace<PartyMemberState>(npc);
 
@@ -135,6 +137,7 @@ namespace sage
         assert(party.size() < PARTY_MEMBER_MAX);
         party.push_back(member);
         groups.at(0).push_back(member);
+        registry->get<MoveableActor>(member).movementGroup = movementGroup;
         onPartyChange.Publish();
     }
 
@@ -145,6 +148,10 @@ namespace sage
             if (*it == entity)
             {
                 party.erase(it);
+                if (registry->any_of<MoveableActor>(entity))
+                {
+                    registry->get<MoveableActor>(entity).movementGroup = entt::null;
+                }
                 onPartyChange.Publish();
                 return;
             }
@@ -196,7 +203,8 @@ namespace sage
         return {};
     }
 
-    PartySystem::PartySystem(entt::registry* _registry, Systems* _sys) : registry(_registry), sys(_sys)
+    PartySystem::PartySystem(entt::registry* _registry, Systems* _sys)
+        : registry(_registry), sys(_sys), movementGroup(_registry->create())
     {
         groups.resize(1);
 
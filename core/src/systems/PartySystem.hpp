@@ -23,6 +23,7 @@ namespace sage
         Systems* sys;
         std::vector<entt::entity> party;
         std::vector<std::vector<entt::entity>> groups;
+        entt::entity movementGroup; // See MoveableActor::movementGroup
 
       public:
         Event<> onPartyChange;
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "components/Collideable.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <cstdint>
+
+namespace sage
+{
+    // One bit per CollisionLayer
+    using CollisionLayerMask = uint32_t;
+
+    [[nodiscard]] constexpr CollisionLayerMask LayerBit(const CollisionLayer layer)
+    {
+        return CollisionLayerMask{1} << static_cast<uint32_t>(layer);
+    }
+
+    // A collideable, as StaticBvh and DynamicAabbTree hold it
+    struct CollisionProxy
+    {
+        entt::entity entity = entt::null;
+        BoundingBox box{};
+        CollisionLayer layer{};
+    };
+} // namespace sage
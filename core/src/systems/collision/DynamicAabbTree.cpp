@@ -0,0 +1,303 @@
+#include "DynamicAabbTree.hpp"
+
+#include <algorithm>
+
+namespace sage
+{
+    namespace
+    {
+        BoundingBox merge(const BoundingBox& a, const BoundingBox& b)
+        {
+            return {Vector3Min(a.min, b.min), Vector3Max(a.max, b.max)};
+        }
+
+        BoundingBox fatten(const BoundingBox& box, const float margin)
+        {
+            const Vector3 extension{margin, margin, margin};
+            return {Vector3Subtract(box.min, extension), Vector3Add(box.max, extension)};
+        }
+
+        bool encloses(const BoundingBox& outer, const BoundingBox& inner)
+        {
+            return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+                   outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+        }
+
+        // Half the surface area, which is all the insertion cost needs
+        float area(const BoundingBox& box)
+        {
+            const Vector3 size = Vector3Subtract(box.max, box.min);
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+    } // namespace
+
+    int32_t DynamicAabbTree::allocateNode()
+    {
+        if (freeList == NULL_NODE)
+        {
+            nodes.emplace_back();
+            return static_cast<int32_t>(nodes.size()) - 1;
+        }
+        const int32_t index = freeList;
+        freeList = nodes[index].parent;
+        nodes[index] = Node{};
+        return index;
+    }
+
+    void DynamicAabbTree::freeNode(const int32_t index)
+    {
+        nodes[index] = Node{};
+        nodes[index].parent = freeList;
+        freeList = index;
+    }
+
+    void DynamicAabbTree::insertLeaf(const int32_t leaf)
+    {
+        if (root == NULL_NODE)
+        {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling, going down the tree while that is cheaper than pairing with the current node
+        const BoundingBox leafBox = nodes[leaf].box;
+        int32_t index = root;
+        while (!nodes[index].IsLeaf())
+        {
+            const Node& node = nodes[index];
+            const float nodeArea = area(node.box);
+            const float combinedArea = area(merge(node.box, leafBox));
+
+            // Cost of pairing with this node, and the cost pushed down to its children
+            const float cost = 2.0f * combinedArea;
+            const float inheritanceCost = 2.0f * (combinedArea - nodeArea);
+
+            auto descendCost = [&](const int32_t child) {
+                const Node& c = nodes[child];
+                const float merged = area(merge(leafBox, c.box));
+                return (c.IsLeaf() ? merged : merged - area(c.box)) + inheritanceCost;
+            };
+            const float cost1 = descendCost(node.child1);
+            const float cost2 = descendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const int32_t sibling = index;
+        const int32_t oldParent = nodes[sibling].parent;
+        const int32_t newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = merge(leafBox, nodes[sibling].box);
+        nodes[newParent].layers = nodes[leaf].layers | nodes[sibling].layers;
+        nodes[newParent].height = nodes[sibling].height + 1;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (nodes[oldParent].child1 == sibling)
+                nodes[oldParent].child1 = newParent;
+            else
+                nodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            root = newParent;
+        }
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        refitAncestors(nodes[leaf].parent);
+    }
+
+    void DynamicAabbTree::removeLeaf(const int32_t leaf)
+    {
+        if (leaf == root)
+        {
+            root = NULL_NODE;
+            return;
+        }
+
+        const int32_t parent = nodes[leaf].parent;
+        const int32_t grandParent = nodes[parent].parent;
+        const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent != NULL_NODE)
+        {
+            // The sibling takes the parent's place
+            if (nodes[grandParent].child1 == parent)
+                nodes[grandParent].child1 = sibling;
+            else
+                nodes[grandParent].child2 = sibling;
+            nodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refitAncestors(grandParent);
+        }
+        else
+        {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+    }
+
+    void DynamicAabbTree::refitAncestors(int32_t index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+            Node& node = nodes[index];
+            const Node& child1 = nodes[node.child1];
+            const Node& child2 = nodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.box = merge(child1.box, child2.box);
+            node.layers = child1.layers | child2.layers;
+            index = node.parent;
+        }
+    }
+
+    // AVL rotation. Returns the node that now takes the place of "index".
+    int32_t DynamicAabbTree::balance(const int32_t index)
+    {
+        const int32_t iA = index;
+        Node& a = nodes[iA];
+        if (a.IsLeaf() || a.height < 2) return iA;
+
+        const int32_t iB = a.child1;
+        const int32_t iC = a.child2;
+        Node& b = nodes[iB];
+        Node& c = nodes[iC];
+        const int32_t heightDifference = c.height - b.height;
+
+        // Puts "up" (a child of A) in A's place, with A as its first child
+        auto rotateUp = [&](const int32_t iUp, Node& up) {
+            up.child1 = iA;
+            up.parent = a.parent;
+            a.parent = iUp;
+            if (up.parent == NULL_NODE)
+                root = iUp;
+            else if (nodes[up.parent].child1 == iA)
+                nodes[up.parent].child1 = iUp;
+            else
+                nodes[up.parent].child2 = iUp;
+        };
+        auto refit = [this](Node& node) {
+            const Node& child1 = nodes[node.child1];
+            const Node& child2 = nodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.box = merge(child1.box, child2.box);
+            node.layers = child1.layers | child2.layers;
+        };
+
+        if (heightDifference > 1)
+        {
+            // C goes up. A keeps B and takes the shorter of C's children.
+            const int32_t iF = c.child1;
+            const int32_t iG = c.child2;
+            rotateUp(iC, c);
+            const bool keepF = nodes[iF].height > nodes[iG].height;
+            const int32_t iKept = keepF ? iF : iG;
+            const int32_t iGiven = keepF ? iG : iF;
+            c.child2 = iKept;
+            a.child2 = iGiven;
+            nodes[iGiven].parent = iA;
+            refit(a);
+            refit(c);
+            return iC;
+        }
+        if (heightDifference < -1)
+        {
+            // B goes up. A keeps C and takes the shorter of B's children.
+            const int32_t iD = b.child1;
+            const int32_t iE = b.child2;
+            rotateUp(iB, b);
+            const bool keepD = nodes[iD].height > nodes[iE].height;
+            const int32_t iKept = keepD ? iD : iE;
+            const int32_t iGiven = keepD ? iE : iD;
+            b.child2 = iKept;
+            a.child1 = iGiven;
+            nodes[iGiven].parent = iA;
+            refit(a);
+            refit(b);
+            return iB;
+        }
+        return iA;
+    }
+
+    void DynamicAabbTree::Insert(const CollisionProxy& proxy)
+    {
+        assert(!leaves.contains(proxy.entity));
+        const int32_t leaf = allocateNode();
+        Node& node = nodes[leaf];
+        node.proxy = proxy;
+        node.box = fatten(proxy.box, FAT_MARGIN);
+        node.layers = LayerBit(proxy.layer);
+        node.height = 0;
+        leaves.emplace(proxy.entity, leaf);
+        insertLeaf(leaf);
+    }
+
+    void DynamicAabbTree::Remove(const entt::entity entity)
+    {
+        const auto it = leaves.find(entity);
+        if (it == leaves.end()) return;
+        removeLeaf(it->second);
+        freeNode(it->second);
+        leaves.erase(it);
+    }
+
+    bool DynamicAabbTree::Move(const entt::entity entity, const BoundingBox& box)
+    {
+        const auto it = leaves.find(entity);
+        if (it == leaves.end()) return false;
+        const int32_t leaf = it->second;
+        nodes[leaf].proxy.box = box;
+
+        const BoundingBox& fat = nodes[leaf].box;
+        if (encloses(fat, box) && encloses(fatten(box, FAT_MARGIN * 4), fat)) return false;
+
+        removeLeaf(leaf);
+        nodes[leaf].box = fatten(box, FAT_MARGIN);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    void DynamicAabbTree::SetLayer(const entt::entity entity, const CollisionLayer layer)
+    {
+        const auto it = leaves.find(entity);
+        if (it == leaves.end()) return;
+        const int32_t leaf = it->second;
+        if (nodes[leaf].proxy.layer == layer) return;
+        nodes[leaf].proxy.layer = layer;
+        nodes[leaf].layers = LayerBit(layer);
+        for (int32_t index = nodes[leaf].parent; index != NULL_NODE; index = nodes[index].parent)
+        {
+            nodes[index].layers = nodes[nodes[index].child1].layers | nodes[nodes[index].child2].layers;
+        }
+    }
+
+    void DynamicAabbTree::Clear()
+    {
+        nodes.clear();
+        leaves.clear();
+        root = NULL_NODE;
+        freeList = NULL_NODE;
+    }
+
+    bool DynamicAabbTree::Contains(const entt::entity entity) const
+    {
+        return leaves.contains(entity);
+    }
+
+    size_t DynamicAabbTree::Size() const
+    {
+        return leaves.size();
+    }
+
+    int DynamicAabbTree::Height() const
+    {
+        return root == NULL_NODE ? 0 : nodes[root].height;
+    }
+} // namespace sage
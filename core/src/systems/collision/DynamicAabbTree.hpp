@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CollisionProxy.hpp"
+
+#include "Bvh.hpp"
+#include "entt/entt.hpp"
+#include "raylib.h"
+#include "raymath.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace sage
+{
+    // Bounding volume tree over dynamic collideables, as Box2D's b2DynamicTree. Leaves are fattened by FAT_MARGIN,
+    // so an actor is only reinserted once it leaves its box.
+    class DynamicAabbTree
+    {
+        static constexpr int32_t NULL_NODE = -1;
+
+        struct Node
+        {
+            BoundingBox box{}; // Fattened, for leaves
+            CollisionProxy proxy{}; // Leaves only. Holds the tight box.
+            CollisionLayerMask layers = 0;
+            int32_t parent = NULL_NODE; // Next free node, while free
+            int32_t child1 = NULL_NODE;
+            int32_t child2 = NULL_NODE;
+            int32_t height = -1; // Leaves are 0, free nodes -1
+
+            [[nodiscard]] bool IsLeaf() const
+            {
+                return child1 == NULL_NODE;
+            }
+        };
+
+        std::vector<Node> nodes;
+        int32_t root = NULL_NODE;
+        int32_t freeList = NULL_NODE;
+        std::unordered_map<entt::entity, int32_t> leaves;
+
+        [[nodiscard]] int32_t allocateNode();
+        void freeNode(int32_t index);
+        void insertLeaf(int32_t leaf);
+        void removeLeaf(int32_t leaf);
+        // Rebalances and refits from "index" up to the root
+        void refitAncestors(int32_t index);
+        [[nodiscard]] int32_t balance(int32_t index);
+
+      public:
+        static constexpr float FAT_MARGIN = 0.5f;
+
+        void Insert(const CollisionProxy& proxy);
+        void Remove(entt::entity entity);
+        // Returns whether the entity was reinserted
+        bool Move(entt::entity entity, const BoundingBox& box);
+        void SetLayer(entt::entity entity, CollisionLayer layer);
+        void Clear();
+        [[nodiscard]] bool Contains(entt::entity entity) const;
+        [[nodiscard]] size_t Size() const;
+        [[nodiscard]] int Height() const;
+
+        // As StaticBvh::QueryBox
+        template <typename Visitor>
+        void QueryBox(const BoundingBox& box, CollisionLayerMask layers, Visitor&& visitor) const;
+
+        // As StaticBvh::QueryRay
+        template <typename Visitor>
+        void QueryRay(const Ray& ray, CollisionLayerMask layers, float& maxDistance, Visitor&& visitor) const;
+    };
+
+    template <typename Visitor>
+    void DynamicAabbTree::QueryBox(
+        const BoundingBox& box, const CollisionLayerMask layers, Visitor&& visitor) const
+    {
+        if (root == NULL_NODE) return;
+
+        auto overlaps = [&box](const BoundingBox& other) {
+            return other.min.x <= box.max.x && other.max.x >= box.min.x && other.min.y <= box.max.y &&
+                   other.max.y >= box.min.y && other.min.z <= box.max.z && other.max.z >= box.min.z;
+        };
+
+        std::array<int32_t, BVH_MAX_DEPTH + 1> stack{};
+        int top = 0;
+        stack[top++] = root;
+        while (top > 0)
+        {
+            const Node& node = nodes[stack[--top]];
+            if (!(node.layers & layers) || !overlaps(node.box)) continue;
+            if (node.IsLeaf())
+            {
+                if (!overlaps(node.proxy.box)) continue;
+                if (!visitor(node.proxy)) return;
+                continue;
+            }
+            assert(top + 2 <= static_cast<int>(stack.size()));
+            stack[top++] = node.child2;
+            stack[top++] = node.child1;
+        }
+    }
+
+    template <typename Visitor>
+    void DynamicAabbTree::QueryRay(
+        const Ray& ray, const CollisionLayerMask layers, float& maxDistance, Visitor&& visitor) const
+    {
+        if (root == NULL_NODE) return;
+        const float length = Vector3Length(ray.direction);
+        if (length <= 0) return;
+
+        const Vector3 direction = Vector3Scale(ray.direction, 1.0f / length);
+        const Vector3 inverseDirection{1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z};
+        auto entry = [&](const int32_t index) {
+            const Node& node = nodes[index];
+            if (!(node.layers & layers)) return std::numeric_limits<float>::infinity();
+            return RayBoxEntry(ray.position, inverseDirection, node.box.min, node.box.max, maxDistance);
+        };
+
+        // Nodes still to visit, with the distance the ray enters them at
+        std::array<std::pair<int32_t, float>, BVH_MAX_DEPTH + 1> stack{};
+        int top = 0;
+        if (const float rootEntry = entry(root); !std::isinf(rootEntry)) stack[top++] = {root, rootEntry};
+        while (top > 0)
+        {
+            const auto [index, nodeEntry] = stack[--top];
+            if (nodeEntry > maxDistance) continue; // The visitor lowered maxDistance since it was pushed
+            const Node& node = nodes[index];
+            if (node.IsLeaf())
+            {
+                const auto& proxy = node.proxy;
+                const float proxyEntry =
+                    RayBoxEntry(ray.position, inverseDirection, proxy.box.min, proxy.box.max, maxDistance);
+                if (std::isinf(proxyEntry)) continue;
+                if (!visitor(proxy)) return;
+                continue;
+            }
+
+            // Visit the nearer child first, so that the farther one can often be skipped
+            int32_t nearIndex = node.child1, farIndex = node.child2;
+            float nearEntry = entry(nearIndex), farEntry = entry(farIndex);
+            if (farEntry < nearEntry)
+            {
+                std::swap(nearIndex, farIndex);
+                std::swap(nearEntry, farEntry);
+            }
+            assert(top + 2 <= static_cast<int>(stack.size()));
+            if (!std::isinf(farEntry)) stack[top++] = {farIndex, farEntry};
+            if (!std::isinf(nearEntry)) stack[top++] = {nearIndex, nearEntry};
+        }
+    }
+} // namespace sage
@@ -0,0 +1,103 @@
+#include "StaticBvh.hpp"
+
+namespace sage
+{
+    namespace
+    {
+        constexpr uint32_t MAX_LEAF_SIZE = 4;
+        static_assert(static_cast<int>(CollisionLayer::COUNT) <= 32, "CollisionLayerMask has one bit per layer");
+    } // namespace
+
+    void StaticBvh::refit()
+    {
+        // Children always come after their parent, so walking backwards refits them first
+        for (auto i = static_cast<int64_t>(nodes.size()) - 1; i >= 0; --i)
+        {
+            auto& node = nodes[i];
+            BvhBounds bounds;
+            CollisionLayerMask layers = 0;
+            if (node.count > 0)
+            {
+                for (uint32_t p = node.first; p < node.first + node.count; ++p)
+                {
+                    if (proxies[p].entity == entt::null) continue;
+                    bounds.Grow(proxies[p].box.min);
+                    bounds.Grow(proxies[p].box.max);
+                    layers |= LayerBit(proxies[p].layer);
+                }
+            }
+            else
+            {
+                for (const uint32_t child : {static_cast<uint32_t>(i) + 1, node.first})
+                {
+                    bounds.Grow(nodes[child].min);
+                    bounds.Grow(nodes[child].max);
+                    layers |= nodeLayers[child];
+                }
+            }
+            node.min = bounds.min;
+            node.max = bounds.max;
+            nodeLayers[i] = layers;
+        }
+    }
+
+    void StaticBvh::Build(const std::vector<CollisionProxy>& _proxies)
+    {
+        std::vector<BvhBounds> bounds(_proxies.size());
+        for (size_t i = 0; i < _proxies.size(); ++i)
+        {
+            bounds[i].Grow(_proxies[i].box.min);
+            bounds[i].Grow(_proxies[i].box.max);
+        }
+
+        std::vector<uint32_t> order;
+        nodes = BuildBvh(bounds, MAX_LEAF_SIZE, order);
+        proxies.resize(_proxies.size());
+        proxyIndex.clear();
+        proxyIndex.reserve(_proxies.size());
+        for (uint32_t i = 0; i < order.size(); ++i)
+        {
+            proxies[i] = _proxies[order[i]];
+            proxyIndex[proxies[i].entity] = i;
+        }
+        nodeLayers.assign(nodes.size(), 0);
+        refit();
+    }
+
+    void StaticBvh::Clear()
+    {
+        nodes.clear();
+        nodeLayers.clear();
+        proxies.clear();
+        proxyIndex.clear();
+    }
+
+    bool StaticBvh::Contains(const entt::entity entity) const
+    {
+        return proxyIndex.contains(entity);
+    }
+
+    size_t StaticBvh::Size() const
+    {
+        return proxyIndex.size();
+    }
+
+    void StaticBvh::Update(const entt::entity entity, const BoundingBox& box, const CollisionLayer layer)
+    {
+        const auto it = proxyIndex.find(entity);
+        if (it == proxyIndex.end()) return;
+        auto& proxy = proxies[it->second];
+        proxy.box = box;
+        proxy.layer = layer;
+        refit();
+    }
+
+    void StaticBvh::Remove(const entt::entity entity)
+    {
+        const auto it = proxyIndex.find(entity);
+        if (it == proxyIndex.end()) return;
+        // The nodes above keep their bounds and layers, which still contain everything left below them
+        proxies[it->second].entity = entt::null;
+        proxyIndex.erase(it);
+    }
+} // namespace sage
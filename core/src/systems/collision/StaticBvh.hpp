@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CollisionProxy.hpp"
+
+#include "Bvh.hpp"
+#include "entt/entt.hpp"
+#include "raylib.h"
+#include "raymath.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace sage
+{
+    // BVH over static collideables, built once the map has loaded. Nodes keep the layers below them, so queries
+    // skip subtrees their layer does not collide with. Updates refit rather than rebuild.
+    class StaticBvh
+    {
+        std::vector<BvhNode> nodes;
+        std::vector<CollisionLayerMask> nodeLayers;
+        std::vector<CollisionProxy> proxies; // In node order. Removed proxies are left as entt::null.
+        std::unordered_map<entt::entity, uint32_t> proxyIndex;
+
+        void refit();
+
+      public:
+        void Build(const std::vector<CollisionProxy>& _proxies);
+        void Clear();
+        [[nodiscard]] bool Contains(entt::entity entity) const;
+        [[nodiscard]] size_t Size() const;
+        void Update(entt::entity entity, const BoundingBox& box, CollisionLayer layer);
+        // Nothing is refit, so tearing down a map stays cheap
+        void Remove(entt::entity entity);
+
+        // The visitor returns false to stop the query
+        template <typename Visitor>
+        void QueryBox(const BoundingBox& box, CollisionLayerMask layers, Visitor&& visitor) const;
+
+        // Nearest nodes first. The visitor may lower "maxDistance" to prune the rest of the query.
+        template <typename Visitor>
+        void QueryRay(const Ray& ray, CollisionLayerMask layers, float& maxDistance, Visitor&& visitor) const;
+    };
+
+    template <typename Visitor>
+    void StaticBvh::QueryBox(const BoundingBox& box, const CollisionLayerMask layers, Visitor&& visitor) const
+    {
+        if (nodes.empty()) return;
+
+        auto overlaps = [&box](const Vector3 min, const Vector3 max) {
+            return min.x <= box.max.x && max.x >= box.min.x && min.y <= box.max.y && max.y >= box.min.y &&
+                   min.z <= box.max.z && max.z >= box.min.z;
+        };
+
+        std::array<uint32_t, BVH_MAX_DEPTH + 1> stack{};
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const uint32_t nodeIndex = stack[--top];
+            const BvhNode& node = nodes[nodeIndex];
+            if (!(nodeLayers[nodeIndex] & layers) || !overlaps(node.min, node.max)) continue;
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    const auto& proxy = proxies[i];
+                    if (proxy.entity == entt::null || !(LayerBit(proxy.layer) & layers)) continue;
+                    if (!overlaps(proxy.box.min, proxy.box.max)) continue;
+                    if (!visitor(proxy)) return;
+                }
+                continue;
+            }
+            stack[top++] = node.first;
+            stack[top++] = nodeIndex + 1;
+        }
+    }
+
+    template <typename Visitor>
+    void StaticBvh::QueryRay(
+        const Ray& ray, const CollisionLayerMask layers, float& maxDistance, Visitor&& visitor) const
+    {
+        if (nodes.empty()) return;
+        const float length = Vector3Length(ray.direction);
+        if (length <= 0) return;
+
+        const Vector3 direction = Vector3Scale(ray.direction, 1.0f / length);
+        const Vector3 inverseDirection{1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z};
+        auto entry = [&](const uint32_t nodeIndex) {
+            if (!(nodeLayers[nodeIndex] & layers)) return std::numeric_limits<float>::infinity();
+            const auto& node = nodes[nodeIndex];
+            return RayBoxEntry(ray.position, inverseDirection, node.min, node.max, maxDistance);
+        };
+
+        // Nodes still to visit, with the distance the ray enters them at
+        std::array<std::pair<uint32_t, float>, BVH_MAX_DEPTH + 1> stack{};
+        int top = 0;
+        if (const float rootEntry = entry(0); !std::isinf(rootEntry)) stack[top++] = {0, rootEntry};
+        while (top > 0)
+        {
+            const auto [nodeIndex, nodeEntry] = stack[--top];
+            if (nodeEntry > maxDistance) continue; // The visitor lowered maxDistance since it was pushed
+            const BvhNode& node = nodes[nodeIndex];
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    const auto& proxy = proxies[i];
+                    if (proxy.entity == entt::null || !(LayerBit(proxy.layer) & layers)) continue;
+                    const float proxyEntry =
+                        RayBoxEntry(ray.position, inverseDirection, proxy.box.min, proxy.box.max, maxDistance);
+                    if (std::isinf(proxyEntry)) continue;
+                    if (!visitor(proxy)) return;
+                }
+                continue;
+            }
+
+            // Visit the nearer child first, so that the farther one can often be skipped
+            uint32_t nearIndex = nodeIndex + 1, farIndex = node.first;
+            float nearEntry = entry(nearIndex), farEntry = entry(farIndex);
+            if (farEntry < nearEntry)
+            {
+                std::swap(nearIndex, farIndex);
+                std::swap(nearEntry, farEntry);
+            }
+            if (!std::isinf(farEntry)) stack[top++] = {farIndex, farEntry};
+            if (!std::isinf(nearEntry)) stack[top++] = {nearIndex, nearEntry};
+        }
+    }
+} // namespace sage
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace sage
+{
+    // One value per square, in CHUNK_SIZE * CHUNK_SIZE chunks. A chunk is only allocated while one of its squares
+    // differs from "fill", and unallocated chunks read as "fill". Const reads are safe from several threads as
+    // long as nothing writes.
+    template <typename T>
+    class ChunkedLayer
+    {
+      public:
+        static constexpr int CHUNK_SIZE = 64;
+
+      private:
+        static constexpr int CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+
+        struct Chunk
+        {
+            std::array<T, CHUNK_AREA> values;
+            int changed = 0; // Squares that differ from "fill". The chunk is freed when this drops to zero.
+        };
+
+        int slices = 0;
+        int chunksPerSide = 0;
+        T fill{};
+        std::vector<std::unique_ptr<Chunk>> chunks; // Null while every square is "fill"
+
+        [[nodiscard]] int chunkIndex(const GridSquare square) const
+        {
+            return square.row / CHUNK_SIZE * chunksPerSide + square.col / CHUNK_SIZE;
+        }
+
+        [[nodiscard]] static int squareIndex(const GridSquare square)
+        {
+            return square.row % CHUNK_SIZE * CHUNK_SIZE + square.col % CHUNK_SIZE;
+        }
+
+      public:
+        void Init(const int _slices, const T& _fill)
+        {
+            slices = _slices;
+            chunksPerSide = (slices + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            fill = _fill;
+            chunks.clear();
+            chunks.resize(static_cast<size_t>(chunksPerSide) * chunksPerSide);
+        }
+
+        // Every square back to "fill"
+        void Clear()
+        {
+            for (auto& chunk : chunks)
+            {
+                chunk.reset();
+            }
+        }
+
+        // Only the chunks overlapping [min, max) are copied. The rest of the copy reads as "fill".
+        [[nodiscard]] ChunkedLayer CopyRange(const GridSquare min, const GridSquare max) const
+        {
+            ChunkedLayer out;
+            out.Init(slices, fill);
+            if (min.row >= max.row || min.col >= max.col) return out;
+            for (int row = min.row / CHUNK_SIZE; row <= (max.row - 1) / CHUNK_SIZE; ++row)
+            {
+                for (int col = min.col / CHUNK_SIZE; col <= (max.col - 1) / CHUNK_SIZE; ++col)
+                {
+                    const auto& chunk = chunks[row * chunksPerSide + col];
+                    if (chunk) out.chunks[row * chunksPerSide + col] = std::make_unique<Chunk>(*chunk);
+                }
+            }
+            return out;
+        }
+
+        [[nodiscard]] const T& Get(const GridSquare square) const
+        {
+            const auto& chunk = chunks[chunkIndex(square)];
+            return chunk ? chunk->values[squareIndex(square)] : fill;
+        }
+
+        void Set(const GridSquare square, const T& value)
+        {
+            auto& chunk = chunks[chunkIndex(square)];
+            if (!chunk)
+            {
+                if (value == fill) return;
+                chunk = std::make_unique<Chunk>();
+                chunk->values.fill(fill);
+            }
+
+            auto& current = chunk->values[squareIndex(square)];
+            const bool wasFill = current == fill;
+            const bool isFill = value == fill;
+            current = value;
+            if (wasFill == isFill) return;
+            chunk->changed += isFill ? -1 : 1;
+            if (chunk->changed == 0) chunk.reset();
+        }
+
+        [[nodiscard]] int AllocatedChunkCount() const
+        {
+            int count = 0;
+            for (const auto& chunk : chunks)
+            {
+                count += chunk != nullptr;
+            }
+            return count;
+        }
+
+        // Calls "visit(square, value)" for every square that differs from "fill"
+        template <typename Visit>
+        void ForEachChanged(Visit&& visit) const
+        {
+            for (int chunk = 0; chunk < static_cast<int>(chunks.size()); ++chunk)
+            {
+                if (!chunks[chunk]) continue;
+                const int firstRow = chunk / chunksPerSide * CHUNK_SIZE;
+                const int firstCol = chunk % chunksPerSide * CHUNK_SIZE;
+                for (int i = 0; i < CHUNK_AREA; ++i)
+                {
+                    const auto& value = chunks[chunk]->values[i];
+                    if (value == fill) continue;
+                    visit(GridSquare{firstRow + i / CHUNK_SIZE, firstCol + i % CHUNK_SIZE}, value);
+                }
+            }
+        }
+    };
+} // namespace sage
@@ -0,0 +1,111 @@
+#include "ClearanceMap.hpp"
+
+#include <algorithm>
+
+namespace sage
+{
+    // Works a row at a time: how far each row is free either side, then how many rows are free by that much
+    void ClearanceMap::recalculate(const ChunkedLayer<uint8_t>& occupied, GridSquare min, GridSquare max)
+    {
+        min = {std::max(min.row, 0), std::max(min.col, 0)};
+        max = {std::min(max.row, slices - 1), std::min(max.col, slices - 1)};
+        if (min.row > max.row || min.col > max.col) return;
+
+        // Rows that a box around any square in [min, max] can reach
+        const int firstRow = std::max(min.row - MAX_CLEARANCE, 0);
+        const int lastRow = std::min(max.row + MAX_CLEARANCE - 1, slices - 1);
+        const int width = max.col - min.col + 1;
+        rowClearance.resize(static_cast<size_t>(lastRow - firstRow + 1) * width);
+
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            for (int col = min.col; col <= max.col; ++col)
+            {
+                int k = 0;
+                while (k < MAX_CLEARANCE)
+                {
+                    const int left = col - k - 1;
+                    const int right = col + k;
+                    if (left < 0 || right >= slices) break;
+                    if (occupied.Get({row, left}) || occupied.Get({row, right})) break;
+                    ++k;
+                }
+                rowClearance[(row - firstRow) * width + (col - min.col)] = static_cast<uint8_t>(k);
+            }
+        }
+
+        for (int row = min.row; row <= max.row; ++row)
+        {
+            for (int col = min.col; col <= max.col; ++col)
+            {
+                int k = 0;
+                int narrowest = MAX_CLEARANCE;
+                while (k < MAX_CLEARANCE)
+                {
+                    const int top = row - k - 1;
+                    const int bottom = row + k;
+                    if (top < 0 || bottom >= slices) break;
+                    narrowest = std::min(
+                        {narrowest,
+                         static_cast<int>(rowClearance[(top - firstRow) * width + (col - min.col)]),
+                         static_cast<int>(rowClearance[(bottom - firstRow) * width + (col - min.col)])});
+                    if (narrowest < k + 1) break;
+                    ++k;
+                }
+                clearance.Set({row, col}, static_cast<uint8_t>(k));
+            }
+        }
+    }
+
+    void ClearanceMap::Init(const int _slices, const ChunkedLayer<uint8_t>& occupied)
+    {
+        slices = _slices;
+        clearance.Init(slices, MAX_CLEARANCE);
+        dirty.clear();
+        recalculate(occupied, {0, 0}, {slices - 1, slices - 1});
+    }
+
+    void ClearanceMap::MarkDirty(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        dirty.emplace_back(
+            GridSquare{minSquare.row - MAX_CLEARANCE + 1, minSquare.col - MAX_CLEARANCE + 1},
+            GridSquare{maxSquare.row + MAX_CLEARANCE, maxSquare.col + MAX_CLEARANCE});
+    }
+
+    void ClearanceMap::Update(const ChunkedLayer<uint8_t>& occupied)
+    {
+        if (dirty.empty()) return;
+
+        // Past this, recalculating everything is cheaper
+        constexpr size_t maxDirtyAreas = 64;
+
+        // An actor that stood still unmarks and re-marks the same area
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+        if (dirty.size() > maxDirtyAreas)
+        {
+            recalculate(occupied, {0, 0}, {slices - 1, slices - 1});
+        }
+        else
+        {
+            for (const auto& [min, max] : dirty)
+            {
+                recalculate(occupied, min, max);
+            }
+        }
+        dirty.clear();
+    }
+
+    std::optional<bool> ClearanceMap::Fits(const GridSquare square, const GridSquare extents) const
+    {
+        if (extents.row <= 0 || extents.col <= 0) return true;
+        if (square.row < 0 || square.col < 0 || square.row >= slices || square.col >= slices) return false;
+
+        const int squareClearance = clearance.Get(square);
+        if (std::max(extents.row, extents.col) <= squareClearance) return true;
+        // Capped values only give a lower bound
+        if (std::min(extents.row, extents.col) > squareClearance && squareClearance < MAX_CLEARANCE) return false;
+        return std::nullopt;
+    }
+} // namespace sage
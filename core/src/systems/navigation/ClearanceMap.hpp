@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ChunkedLayer.hpp"
+#include "components/NavigationGridSquare.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace sage
+{
+    // Largest square footprint that fits around each square, so checking an actor's footprint is one lookup.
+    // Occupancy changes only mark squares dirty; they are recalculated when next read.
+    class ClearanceMap
+    {
+        int slices = 0;
+        // Squares MAX_CLEARANCE from any obstacle and from the edge are left unallocated
+        ChunkedLayer<uint8_t> clearance;
+        std::vector<std::pair<GridSquare, GridSquare>> dirty; // Inclusive ranges of squares to recalculate
+        std::vector<uint8_t> rowClearance;                     // Scratch space for recalculate
+
+        void recalculate(const ChunkedLayer<uint8_t>& occupied, GridSquare min, GridSquare max);
+
+      public:
+        static constexpr int MAX_CLEARANCE = 8;
+
+        void Init(int _slices, const ChunkedLayer<uint8_t>& occupied);
+        // Inclusive range
+        void MarkDirty(GridSquare minSquare, GridSquare maxSquare);
+        // Recalculates any dirty squares.
+        void Update(const ChunkedLayer<uint8_t>& occupied);
+        // Empty if the map cannot tell, e.g., for non-square footprints near obstacles
+        [[nodiscard]] std::optional<bool> Fits(GridSquare square, GridSquare extents) const;
+    };
+} // namespace sage
@@ -0,0 +1,222 @@
+#include "ConnectivityMap.hpp"
+
+#include "NavigationGridView.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace sage
+{
+    namespace
+    {
+        // Walkable squares waiting for flood to give them a component
+        constexpr int32_t UNASSIGNED = ConnectivityMap::NO_LABEL - 1;
+        // Past this many areas, relabelling everything is cheaper
+        constexpr size_t MAX_DIRTY_AREAS = 64;
+        constexpr std::array<GridSquare, 8> neighbours = {
+            {{1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+    } // namespace
+
+    int32_t ConnectivityMap::find(Labels& labels, int32_t label)
+    {
+        while (labels.parent[label] != label)
+        {
+            labels.parent[label] = labels.parent[labels.parent[label]];
+            label = labels.parent[label];
+        }
+        return label;
+    }
+
+    ConnectivityMap::Labels& ConnectivityMap::getLabels(const GridSquare extents)
+    {
+        auto [it, inserted] = labelSets.try_emplace(extents);
+        auto& labels = it->second;
+        if (inserted)
+        {
+            build(labels, extents);
+        }
+        else if (!labels.dirty.empty())
+        {
+            update(labels, extents);
+        }
+        return labels;
+    }
+
+    void ConnectivityMap::build(Labels& labels, const GridSquare extents)
+    {
+        const auto cells = static_cast<size_t>(slices) * slices;
+        labels.walkable.assign(cells, false);
+        labels.label.assign(cells, NO_LABEL);
+        labels.parent.clear();
+        labels.dirty.clear();
+
+        for (int row = 0; row < slices; ++row)
+        {
+            for (int col = 0; col < slices; ++col)
+            {
+                const int cell = row * slices + col;
+                if (navigationGrid->IsStaticallyWalkable({row, col}, extents))
+                {
+                    labels.walkable[cell] = true;
+                    labels.label[cell] = UNASSIGNED;
+                }
+            }
+        }
+
+        for (int cell = 0; cell < static_cast<int>(cells); ++cell)
+        {
+            if (labels.label[cell] == UNASSIGNED)
+            {
+                flood(labels, cell);
+            }
+        }
+    }
+
+    void ConnectivityMap::update(Labels& labels, const GridSquare extents)
+    {
+        // Labels are never reused
+        if (labels.dirty.size() > MAX_DIRTY_AREAS || labels.parent.size() > labels.label.size())
+        {
+            build(labels, extents);
+            return;
+        }
+
+        std::vector<int> newlyWalkable;
+        std::vector<int32_t> shrunk; // Components that lost squares
+        for (const auto& [minSquare, maxSquare] : labels.dirty)
+        {
+            // A square's footprint covers [square - extents, square + extents)
+            const int minRow = std::max(std::min(minSquare.row, minSquare.row - extents.row + 1), 0);
+            const int minCol = std::max(std::min(minSquare.col, minSquare.col - extents.col + 1), 0);
+            const int maxRow = std::min(std::max(maxSquare.row, maxSquare.row + extents.row), slices - 1);
+            const int maxCol = std::min(std::max(maxSquare.col, maxSquare.col + extents.col), slices - 1);
+            for (int row = minRow; row <= maxRow; ++row)
+            {
+                for (int col = minCol; col <= maxCol; ++col)
+                {
+                    const int cell = row * slices + col;
+                    const uint8_t walkable = navigationGrid->IsStaticallyWalkable({row, col}, extents);
+                    if (walkable == labels.walkable[cell]) continue;
+                    labels.walkable[cell] = walkable;
+                    if (walkable)
+                    {
+                        newlyWalkable.push_back(cell);
+                    }
+                    else
+                    {
+                        shrunk.push_back(find(labels, labels.label[cell]));
+                        labels.label[cell] = NO_LABEL;
+                    }
+                }
+            }
+        }
+        labels.dirty.clear();
+
+        // New squares may connect several components
+        for (const int cell : newlyWalkable)
+        {
+            const GridSquare square{cell / slices, cell % slices};
+            int32_t root = NO_LABEL;
+            for (const auto& dir : neighbours)
+            {
+                const auto next = square + dir;
+                if (next.row < 0 || next.col < 0 || next.row >= slices || next.col >= slices) continue;
+                const int32_t nextLabel = labels.label[next.row * slices + next.col];
+                if (nextLabel == NO_LABEL) continue;
+                const int32_t nextRoot = find(labels, nextLabel);
+                if (root == NO_LABEL)
+                {
+                    root = nextRoot;
+                }
+                else if (nextRoot != root)
+                {
+                    labels.parent[nextRoot] = root;
+                }
+            }
+            if (root == NO_LABEL)
+            {
+                root = static_cast<int32_t>(labels.parent.size());
+                labels.parent.push_back(root);
+            }
+            labels.label[cell] = root;
+        }
+
+        if (shrunk.empty()) return;
+
+        // Components that lost squares may have been split
+        std::vector<uint8_t> split(labels.parent.size(), false);
+        for (const auto label : shrunk)
+        {
+            split[find(labels, label)] = true;
+        }
+        for (auto& label : labels.label)
+        {
+            if (label != NO_LABEL && split[find(labels, label)])
+            {
+                label = UNASSIGNED;
+            }
+        }
+        for (int cell = 0; cell < static_cast<int>(labels.label.size()); ++cell)
+        {
+            if (labels.label[cell] == UNASSIGNED)
+            {
+                flood(labels, cell);
+            }
+        }
+    }
+
+    // Gives "from" and every unassigned square connected to it a new label.
+    void ConnectivityMap::flood(Labels& labels, const int from)
+    {
+        const auto label = static_cast<int32_t>(labels.parent.size());
+        labels.parent.push_back(label);
+
+        frontier.clear();
+        frontier.push_back(from);
+        labels.label[from] = label;
+        while (!frontier.empty())
+        {
+            const int cell = frontier.back();
+            frontier.pop_back();
+            const GridSquare square{cell / slices, cell % slices};
+            for (const auto& dir : neighbours)
+            {
+                const auto next = square + dir;
+                if (next.row < 0 || next.col < 0 || next.row >= slices || next.col >= slices) continue;
+                const int nextCell = next.row * slices + next.col;
+                if (labels.label[nextCell] != UNASSIGNED) continue;
+                labels.label[nextCell] = label;
+                frontier.push_back(nextCell);
+            }
+        }
+    }
+
+    void ConnectivityMap::Init(const int _slices)
+    {
+        slices = _slices;
+        labelSets.clear();
+    }
+
+    void ConnectivityMap::MarkChanged(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        for (auto& [extents, labels] : labelSets)
+        {
+            if (labels.dirty.size() > MAX_DIRTY_AREAS) continue;
+            labels.dirty.emplace_back(minSquare, maxSquare);
+        }
+    }
+
+    int32_t ConnectivityMap::GetLabel(const GridSquare square, const GridSquare extents)
+    {
+        if (square.row < 0 || square.col < 0 || square.row >= slices || square.col >= slices) return NO_LABEL;
+
+        auto& labels = getLabels(extents);
+        const int32_t label = labels.label[square.row * slices + square.col];
+        return label == NO_LABEL ? NO_LABEL : find(labels, label);
+    }
+
+    ConnectivityMap::ConnectivityMap(const NavigationGridView* _navigationGrid)
+        : navigationGrid(_navigationGrid)
+    {
+    }
+} // namespace sage
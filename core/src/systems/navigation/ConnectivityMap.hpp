@@ -0,0 +1,49 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridView;
+
+    // Connected components per extents, over static occupancy only, so searches can skip walled off destinations.
+    // Changes are applied when next read: new squares are merged, components that lost squares are flooded again.
+    class ConnectivityMap
+    {
+        struct Labels
+        {
+            std::vector<uint8_t> walkable;
+            // Per square, NO_LABEL if not walkable
+            std::vector<int32_t> label;
+            std::vector<int32_t> parent; // Union-find forest over labels, so that merging components is cheap
+            std::vector<std::pair<GridSquare, GridSquare>> dirty; // Inclusive ranges of changed squares
+        };
+
+        const NavigationGridView* navigationGrid;
+        int slices = 0;
+        std::map<GridSquare, Labels> labelSets; // Keyed by extents
+        std::vector<int> frontier;              // Scratch space for flood
+
+        static int32_t find(Labels& labels, int32_t label);
+        Labels& getLabels(GridSquare extents);
+        void build(Labels& labels, GridSquare extents);
+        void update(Labels& labels, GridSquare extents);
+        void flood(Labels& labels, int from);
+
+      public:
+        static constexpr int32_t NO_LABEL = -1;
+
+        void Init(int _slices);
+        // Inclusive range
+        void MarkChanged(GridSquare minSquare, GridSquare maxSquare);
+        // NO_LABEL if the actor cannot stand there
+        [[nodiscard]] int32_t GetLabel(GridSquare square, GridSquare extents);
+
+        explicit ConnectivityMap(const NavigationGridView* _navigationGrid);
+    };
+} // namespace sage
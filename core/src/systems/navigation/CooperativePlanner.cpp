@@ -0,0 +1,275 @@
+#include "CooperativePlanner.hpp"
+
+#include "PathfindingContext.hpp"
+#include "NavigationGridView.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <numbers>
+
+namespace sage
+{
+    namespace
+    {
+        // Waiting comes first, so that it wins ties with moving back and forth on the spot
+        constexpr std::array<GridSquare, 9> moves = {
+            {{0, 0}, {1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+
+        bool overlaps(const GridSquare aMin, const GridSquare aMax, const GridSquare bMin, const GridSquare bMax)
+        {
+            return aMin.row < bMax.row && bMin.row < aMax.row && aMin.col < bMax.col && bMin.col < aMax.col;
+        }
+    } // namespace
+
+    // Always includes the square itself, so that actors without extents still block each other
+    CooperativePlanner::Reservation CooperativePlanner::footprint(
+        const entt::entity entity, const GridSquare square, const GridSquare extents)
+    {
+        return {
+            entity,
+            square - extents,
+            {square.row + std::max(extents.row, 1), square.col + std::max(extents.col, 1)}};
+    }
+
+    bool CooperativePlanner::overlapsOther(const Reservation& footprint, const std::vector<Reservation>& others)
+    {
+        return std::ranges::any_of(others, [&footprint](const Reservation& other) {
+            return other.entity != footprint.entity &&
+                   overlaps(footprint.min, footprint.max, other.min, other.max);
+        });
+    }
+
+    bool CooperativePlanner::isParked(const Reservation& footprint) const
+    {
+        return std::ranges::any_of(parked, [&footprint](const auto& entry) {
+            const auto& other = entry.second;
+            return other.entity != footprint.entity &&
+                   overlaps(footprint.min, footprint.max, other.min, other.max);
+        });
+    }
+
+    bool CooperativePlanner::canHold(
+        const entt::entity entity, const GridSquare square, const GridSquare extents, const int step) const
+    {
+        const auto fp = footprint(entity, square, extents);
+        if (isParked(fp)) return false;
+        for (size_t i = step; i < reservations.size(); ++i)
+        {
+            if (overlapsOther(fp, reservations[i])) return false;
+        }
+        return true;
+    }
+
+    void CooperativePlanner::prepare(const GridSquare start)
+    {
+        origin = {start.row - WINDOW, start.col - WINDOW};
+        if (++generation == 0)
+        {
+            std::ranges::fill(visited, 0);
+            generation = 1;
+        }
+        std::ranges::fill(walkable, -1);
+        open.clear();
+    }
+
+    void CooperativePlanner::Reset()
+    {
+        for (auto& step : reservations)
+        {
+            step.clear();
+        }
+        parked.clear();
+    }
+
+    void CooperativePlanner::Release(const entt::entity entity)
+    {
+        auto isEntity = [entity](const Reservation& reservation) { return reservation.entity == entity; };
+        for (auto& step : reservations)
+        {
+            std::erase_if(step, isEntity);
+        }
+        std::erase_if(parked, [&isEntity](const auto& entry) { return isEntity(entry.second); });
+    }
+
+    void CooperativePlanner::Reserve(
+        const entt::entity entity,
+        const std::vector<GridSquare>& squares,
+        const GridSquare extents,
+        const int firstStep)
+    {
+        for (size_t i = 0; i < squares.size(); ++i)
+        {
+            const auto fp = footprint(entity, squares[i], extents);
+            const size_t step = firstStep + i;
+            for (size_t held = step; held <= step + 1 && held < reservations.size(); ++held)
+            {
+                reservations[held].push_back(fp);
+            }
+        }
+    }
+
+    void CooperativePlanner::Park(
+        const entt::entity entity, const GridSquare square, const GridSquare extents, const int fromStep)
+    {
+        parked.emplace_back(fromStep, footprint(entity, square, extents));
+    }
+
+    bool CooperativePlanner::IsFree(
+        const entt::entity entity, const GridSquare square, const GridSquare extents, const int step) const
+    {
+        const auto fp = footprint(entity, square, extents);
+        if (step < static_cast<int>(reservations.size()) && overlapsOther(fp, reservations[step])) return false;
+        return std::ranges::none_of(parked, [&fp, step](const auto& entry) {
+            const auto& [from, other] = entry;
+            return from <= step && other.entity != fp.entity && overlaps(fp.min, fp.max, other.min, other.max);
+        });
+    }
+
+    GridSquare CooperativePlanner::FindFreeGoal(
+        const NavigationGridView& navigationGrid,
+        const entt::entity entity,
+        const GridSquare goal,
+        const GridSquare extents) const
+    {
+        if (!isParked(footprint(entity, goal, extents))) return goal;
+
+        const GridSquare maxRange{navigationGrid.GetSlices(), navigationGrid.GetSlices()};
+        for (int radius = 1; radius <= WINDOW; ++radius)
+        {
+            GridSquare best = goal;
+            int bestDistance = std::numeric_limits<int>::max();
+            for (int row = goal.row - radius; row <= goal.row + radius; ++row)
+            {
+                // Only the squares on the edge of the ring
+                const int step = row == goal.row - radius || row == goal.row + radius ? 1 : radius * 2;
+                for (int col = goal.col - radius; col <= goal.col + radius; col += step)
+                {
+                    const GridSquare square{row, col};
+                    const int distance = (row - goal.row) * (row - goal.row) + (col - goal.col) * (col - goal.col);
+                    if (distance >= bestDistance ||
+                        !navigationGrid.IsWalkable(square, extents, {0, 0}, maxRange) ||
+                        isParked(footprint(entity, square, extents)))
+                        continue;
+                    best = square;
+                    bestDistance = distance;
+                }
+            }
+            if (bestDistance != std::numeric_limits<int>::max()) return best;
+        }
+        return goal;
+    }
+
+    bool CooperativePlanner::Plan(
+        const NavigationGridView& navigationGrid,
+        const entt::entity entity,
+        const GridSquare start,
+        const GridSquare goal,
+        const GridSquare extents,
+        const int startStep,
+        std::vector<GridSquare>& steps)
+    {
+        prepare(start);
+        const int area = width * width;
+        const GridSquare maxRange{navigationGrid.GetSlices(), navigationGrid.GetSlices()};
+
+        auto cellIndex = [this](const GridSquare square) {
+            return (square.row - origin.row) * width + (square.col - origin.col);
+        };
+        auto isOpen = [&](const int cell, const GridSquare square) {
+            if (walkable[cell] < 0)
+            {
+                walkable[cell] = navigationGrid.IsWalkable(square, extents, {0, 0}, maxRange) ? 1 : 0;
+            }
+            return walkable[cell] == 1;
+        };
+
+        const int startState = cellIndex(start);
+        visited[startState] = generation;
+        cost[startState] = 0;
+        cameFrom[startState] = -1;
+        open.push_back({octileDistance(start, goal), 0, startState});
+
+        int best = startState;
+        double bestHeuristic = octileDistance(start, goal);
+        int expansions = 0;
+        bool reached = false;
+
+        while (!open.empty())
+        {
+            std::ranges::pop_heap(open, std::greater{});
+            const auto node = open.back();
+            open.pop_back();
+            if (node.g > cost[node.state]) continue;
+
+            const int step = node.state / area;
+            const int cell = node.state % area;
+            const GridSquare square{origin.row + cell / width, origin.col + cell % width};
+
+            if (square == goal && canHold(entity, goal, extents, startStep + step))
+            {
+                best = node.state;
+                reached = true;
+                break;
+            }
+            // The first state popped at the end of the window is the one closest to the goal
+            if (step == WINDOW)
+            {
+                best = node.state;
+                break;
+            }
+            if (const double heuristic = node.f - node.g; heuristic < bestHeuristic)
+            {
+                best = node.state;
+                bestHeuristic = heuristic;
+            }
+            if (++expansions > MAX_EXPANSIONS) break;
+
+            for (const auto& move : moves)
+            {
+                const GridSquare next = square + move;
+                if (next.row < origin.row || next.col < origin.col || next.row >= origin.row + width ||
+                    next.col >= origin.col + width)
+                    continue;
+                const int nextCell = cellIndex(next);
+                // Standing still on the start is always allowed, even if it does not fit there
+                const bool waitingOnStart = next == start && move == GridSquare{0, 0};
+                if ((!waitingOnStart && !isOpen(nextCell, next)) ||
+                    !IsFree(entity, next, extents, startStep + step + 1))
+                    continue;
+
+                const int nextState = (step + 1) * area + nextCell;
+                const double moveCost = move.row != 0 && move.col != 0 ? std::numbers::sqrt2 : 1.0;
+                const double g = node.g + moveCost;
+                if (visited[nextState] == generation && g >= cost[nextState]) continue;
+                visited[nextState] = generation;
+                cost[nextState] = g;
+                cameFrom[nextState] = node.state;
+                open.push_back({g + octileDistance(next, goal), g, nextState});
+                std::ranges::push_heap(open, std::greater{});
+            }
+        }
+
+        steps.clear();
+        for (int state = best; state != -1; state = cameFrom[state])
+        {
+            const int cell = state % area;
+            steps.push_back({origin.row + cell / width, origin.col + cell % width});
+        }
+        std::ranges::reverse(steps);
+
+        Reserve(entity, steps, extents, startStep);
+        return reached;
+    }
+
+    CooperativePlanner::CooperativePlanner() : width(WINDOW * 2 + 1)
+    {
+        reservations.resize(LAST_START_STEP + WINDOW + 2);
+        const size_t area = width * width;
+        visited.assign(area * (WINDOW + 1), 0);
+        cost.resize(area * (WINDOW + 1));
+        cameFrom.resize(area * (WINDOW + 1));
+        walkable.resize(area);
+    }
+} // namespace sage
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include "entt/entt.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridView;
+
+    // Windowed cooperative A* for a group of actors that move together. Members are planned one after another
+    // through space and time for WINDOW steps, and reserve the squares they use so later members plan around them.
+    class CooperativePlanner
+    {
+        struct Reservation
+        {
+            entt::entity entity;
+            GridSquare min;
+            GridSquare max; // Exclusive
+        };
+
+        struct Node
+        {
+            double f;
+            double g;
+            int state;
+
+            bool operator>(const Node& other) const
+            {
+                return f > other.f || (f == other.f && g < other.g);
+            }
+        };
+
+        // A square stays reserved for the step after it is left, so nobody swaps squares with its occupant
+        std::vector<std::vector<Reservation>> reservations;
+        // Held until the next Reset, so no two actors are sent to the same place
+        std::vector<std::pair<int, Reservation>> parked;
+
+        // State is step * area + cell
+        GridSquare origin{};
+        int width = 0;
+        uint32_t generation = 0;
+        std::vector<uint32_t> visited;
+        std::vector<double> cost;
+        std::vector<int> cameFrom;
+        std::vector<int8_t> walkable; // Per cell. -1 until checked.
+        std::vector<Node> open;
+
+        [[nodiscard]] static Reservation footprint(entt::entity entity, GridSquare square, GridSquare extents);
+        [[nodiscard]] static bool overlapsOther(
+            const Reservation& footprint, const std::vector<Reservation>& others);
+        [[nodiscard]] bool isParked(const Reservation& footprint) const;
+        [[nodiscard]] bool canHold(entt::entity entity, GridSquare square, GridSquare extents, int step) const;
+        void prepare(GridSquare start);
+
+      public:
+        static constexpr int WINDOW = 16;
+        // The table has to be Reset after this step
+        static constexpr int LAST_START_STEP = WINDOW * 2;
+        // Past this many expansions, carries on from the most promising step
+        static constexpr int MAX_EXPANSIONS = 4096;
+
+        void Reset();
+        void Release(entt::entity entity);
+        // One square per step
+        void Reserve(
+            entt::entity entity, const std::vector<GridSquare>& squares, GridSquare extents, int firstStep);
+        void Park(entt::entity entity, GridSquare square, GridSquare extents, int fromStep);
+        [[nodiscard]] bool IsFree(entt::entity entity, GridSquare square, GridSquare extents, int step) const;
+        // Returns "goal" if no free square is within WINDOW
+        [[nodiscard]] GridSquare FindFreeGoal(
+            const NavigationGridView& navigationGrid,
+            entt::entity entity,
+            GridSquare goal,
+            GridSquare extents) const;
+        // Fills "steps" from startStep and reserves them. True if the goal was reached.
+        bool Plan(
+            const NavigationGridView& navigationGrid,
+            entt::entity entity,
+            GridSquare start,
+            GridSquare goal,
+            GridSquare extents,
+            int startStep,
+            std::vector<GridSquare>& steps);
+
+        CooperativePlanner();
+    };
+} // namespace sage
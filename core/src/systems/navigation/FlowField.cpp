@@ -0,0 +1,106 @@
+#include "FlowField.hpp"
+
+#include "PathfindingContext.hpp"
+#include "NavigationGridView.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace sage
+{
+    namespace
+    {
+        constexpr float UNREACHABLE = std::numeric_limits<float>::max();
+    } // namespace
+
+    int FlowField::windowIndex(const GridSquare square) const
+    {
+        return (square.row - minRange.row) * (maxRange.col - minRange.col) + (square.col - minRange.col);
+    }
+
+    bool FlowField::IsValid(const GridSquare _goal, const uint32_t _occupancyVersion) const
+    {
+        return goal == _goal && occupancyVersion == _occupancyVersion;
+    }
+
+    bool FlowField::Contains(const GridSquare square) const
+    {
+        return NavigationGridView::CheckWithinBounds(square, minRange, maxRange);
+    }
+
+    float FlowField::GetCost(const GridSquare square) const
+    {
+        return Contains(square) ? integration[windowIndex(square)] : UNREACHABLE;
+    }
+
+    void FlowField::Build(
+        const NavigationGridView& navigationGrid,
+        const GridSquare _goal,
+        const GridSquare extents,
+        const uint32_t _occupancyVersion)
+    {
+        const int slices = navigationGrid.GetSlices();
+        auto index = [slices](const GridSquare square) { return square.row * slices + square.col; };
+        goal = _goal;
+        occupancyVersion = _occupancyVersion;
+        minRange = {std::max(goal.row - RADIUS, 0), std::max(goal.col - RADIUS, 0)};
+        maxRange = {std::min(goal.row + RADIUS + 1, slices), std::min(goal.col + RADIUS + 1, slices)};
+        integration.assign(
+            static_cast<size_t>(maxRange.row - minRange.row) * (maxRange.col - minRange.col), UNREACHABLE);
+
+        if (!Contains(goal)) return;
+
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
+
+        context.Visit(index(goal), goal);
+        context.Push(0, goal);
+
+        while (!context.HeapEmpty())
+        {
+            const auto [priority, current, cost] = context.Pop();
+            if (cost > context.CostSoFar(index(current)))
+            {
+                continue; // Stale entry
+            }
+            integration[windowIndex(current)] = static_cast<float>(cost);
+
+            for (const auto& [dirRow, dirCol] : NavigationGridView::DIRECTIONS)
+            {
+                const GridSquare next = {current.row + dirRow, current.col + dirCol};
+                if (!Contains(next) || !navigationGrid.IsStaticallyWalkable(next, extents)) continue;
+
+                const double newCost = cost + octileDistance(current, next);
+                const int idx = index(next);
+                if (!context.IsVisited(idx) || newCost < context.CostSoFar(idx))
+                {
+                    context.Visit(idx, current, newCost);
+                    context.Push(newCost, next, newCost);
+                }
+            }
+        }
+    }
+
+    bool FlowField::NextSquare(const GridSquare square, GridSquare& next) const
+    {
+        float bestCost = GetCost(square);
+        if (bestCost == UNREACHABLE || square == goal) return false;
+
+        next = square;
+        for (int dRow = -1; dRow <= 1; ++dRow)
+        {
+            for (int dCol = -1; dCol <= 1; ++dCol)
+            {
+                const GridSquare neighbour = {square.row + dRow, square.col + dCol};
+                if (const float cost = GetCost(neighbour); cost < bestCost)
+                {
+                    next = neighbour;
+                    bestCost = cost;
+                }
+            }
+        }
+
+        // Every reachable square has a cheaper neighbour, so this should not happen
+        return next != square;
+    }
+} // namespace sage
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridView;
+
+    // Dijkstra distances to a goal, shared by every actor heading there. Moving actors are ignored, so the field
+    // is only rebuilt when the goal moves or static occupancy changes.
+    class FlowField
+    {
+        GridSquare goal{-1, -1};
+        GridSquare minRange{};
+        GridSquare maxRange{}; // Exclusive
+        uint32_t occupancyVersion = 0;
+        std::vector<float> integration; // Cost to reach the goal, for each square in the window
+
+        [[nodiscard]] int windowIndex(GridSquare square) const;
+
+      public:
+        static constexpr int RADIUS = 64;
+
+        [[nodiscard]] bool IsValid(GridSquare _goal, uint32_t _occupancyVersion) const;
+        void Build(
+            const NavigationGridView& navigationGrid,
+            GridSquare _goal,
+            GridSquare extents,
+            uint32_t _occupancyVersion);
+        [[nodiscard]] bool Contains(GridSquare square) const;
+        [[nodiscard]] float GetCost(GridSquare square) const;
+        // False at the goal, or if it is out of reach
+        bool NextSquare(GridSquare square, GridSquare& next) const;
+    };
+} // namespace sage
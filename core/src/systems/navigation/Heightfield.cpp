@@ -0,0 +1,100 @@
+#include "Heightfield.hpp"
+
+#include "components/NavigationGridSquare.hpp"
+
+#include "raymath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sage
+{
+    namespace
+    {
+        float signNotZero(const float value)
+        {
+            return value >= 0.0f ? 1.0f : -1.0f;
+        }
+
+        uint32_t toUnorm16(const float value)
+        {
+            return static_cast<uint32_t>(std::lround((std::clamp(value, -1.0f, 1.0f) * 0.5f + 0.5f) * 65535.0f));
+        }
+
+        float fromUnorm16(const uint32_t value)
+        {
+            return static_cast<float>(value) / 65535.0f * 2.0f - 1.0f;
+        }
+    } // namespace
+
+    // Projects the normal onto an octahedron and unfolds it into a square, with y (up) as the octahedron's axis.
+    uint32_t Heightfield::EncodeNormal(const Vector3 normal)
+    {
+        const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length <= 0.0f) return EncodeNormal({0, 1, 0});
+
+        float u = normal.x / length;
+        float v = normal.z / length;
+        if (normal.y < 0.0f)
+        {
+            const float foldedU = (1.0f - std::abs(v)) * signNotZero(u);
+            v = (1.0f - std::abs(u)) * signNotZero(v);
+            u = foldedU;
+        }
+        return toUnorm16(u) | toUnorm16(v) << 16;
+    }
+
+    Vector3 Heightfield::DecodeNormal(const uint32_t encoded)
+    {
+        const float u = fromUnorm16(encoded & 0xFFFF);
+        const float v = fromUnorm16(encoded >> 16);
+        Vector3 normal{u, 1.0f - std::abs(u) - std::abs(v), v};
+        if (normal.y < 0.0f)
+        {
+            normal.x = (1.0f - std::abs(v)) * signNotZero(u);
+            normal.z = (1.0f - std::abs(u)) * signNotZero(v);
+        }
+        return Vector3Normalize(normal);
+    }
+
+    void Heightfield::Pack(
+        const int _slices, const std::vector<float>& _heights, const std::vector<Vector3>& _normals)
+    {
+        slices = _slices;
+        minHeight = 0;
+        maxHeight = 0;
+        bool first = true;
+        for (const auto height : _heights)
+        {
+            if (height == NAVIGATION_GRID_NO_HEIGHT) continue;
+            minHeight = first ? height : std::min(minHeight, height);
+            maxHeight = first ? height : std::max(maxHeight, height);
+            first = false;
+        }
+
+        // NO_HEIGHT is kept back for squares without terrain
+        const float range = maxHeight - minHeight;
+        const float scale = range > 0.0f ? (NO_HEIGHT - 1) / range : 0.0f;
+        heights.resize(_heights.size());
+        for (size_t i = 0; i < _heights.size(); ++i)
+        {
+            heights[i] = _heights[i] == NAVIGATION_GRID_NO_HEIGHT
+                             ? NO_HEIGHT
+                             : static_cast<uint16_t>(std::lround((_heights[i] - minHeight) * scale));
+        }
+
+        normals.resize(_normals.size());
+        std::ranges::transform(_normals, normals.begin(), EncodeNormal);
+    }
+
+    float Heightfield::GetHeight(const size_t index) const
+    {
+        if (heights[index] == NO_HEIGHT) return NAVIGATION_GRID_NO_HEIGHT;
+        return minHeight + heights[index] * ((maxHeight - minHeight) / (NO_HEIGHT - 1));
+    }
+
+    Vector3 Heightfield::GetNormal(const size_t index) const
+    {
+        return DecodeNormal(normals[index]);
+    }
+} // namespace sage
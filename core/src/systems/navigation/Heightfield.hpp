@@ -0,0 +1,34 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sage
+{
+    // Terrain packed for the map file: 16-bit heights over the map's height range, octahedral normals
+    struct Heightfield
+    {
+        static constexpr uint16_t NO_HEIGHT = UINT16_MAX;
+
+        int slices = 0;
+        float minHeight = 0;
+        float maxHeight = 0;
+        std::vector<uint16_t> heights; // Row major, as the navigation grid
+        std::vector<uint32_t> normals;
+
+        static uint32_t EncodeNormal(Vector3 normal);
+        static Vector3 DecodeNormal(uint32_t encoded);
+        void Pack(int _slices, const std::vector<float>& _heights, const std::vector<Vector3>& _normals);
+        [[nodiscard]] float GetHeight(size_t index) const;
+        [[nodiscard]] Vector3 GetNormal(size_t index) const;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(slices, minHeight, maxHeight, heights, normals);
+        }
+    };
+} // namespace sage
@@ -0,0 +1,426 @@
+#include "HierarchicalGrid.hpp"
+
+#include "PathfindingContext.hpp"
+#include "NavigationGridView.hpp"
+
+#include <algorithm>
+
+namespace sage
+{
+    namespace
+    {
+        constexpr int WIDE_ENTRANCE = 6;
+    } // namespace
+
+    int HierarchicalGrid::gridIndex(const GridSquare square) const
+    {
+        return square.row * slices + square.col;
+    }
+
+    int HierarchicalGrid::clusterIndex(const GridSquare square) const
+    {
+        return (square.row / CLUSTER_SIZE) * clustersPerSide + square.col / CLUSTER_SIZE;
+    }
+
+    GridSquare HierarchicalGrid::clusterMin(const int cluster) const
+    {
+        return {(cluster / clustersPerSide) * CLUSTER_SIZE, (cluster % clustersPerSide) * CLUSTER_SIZE};
+    }
+
+    GridSquare HierarchicalGrid::clusterMax(const int cluster) const
+    {
+        const auto min = clusterMin(cluster);
+        return {std::min(min.row + CLUSTER_SIZE, slices), std::min(min.col + CLUSTER_SIZE, slices)};
+    }
+
+    // Ignores moving actors
+    bool HierarchicalGrid::isOpen(
+        const GridSquare square,
+        const GridSquare extents,
+        const GridSquare minRange,
+        const GridSquare maxRange) const
+    {
+        return NavigationGridView::CheckWithinBounds(square, minRange, maxRange) &&
+               navigationGrid->IsStaticallyWalkable(square, extents);
+    }
+
+    void HierarchicalGrid::rebuild(const GridSquare extents, GraphEntry& entry) const
+    {
+        const auto clusterCount = static_cast<size_t>(clustersPerSide) * clustersPerSide;
+
+        // Unchanged clusters are shared with the previous graph
+        auto graph = std::make_shared<AbstractGraph>();
+        if (entry.graph) graph->clusters = entry.graph->clusters;
+        graph->extents = extents;
+        graph->clusters.resize(clusterCount);
+        entry.dirty.resize(clusterCount, true);
+        for (int i = 0; i < static_cast<int>(clusterCount); ++i)
+        {
+            if (entry.dirty[i])
+            {
+                graph->clusters[i] = buildCluster(extents, i);
+                entry.dirty[i] = false;
+            }
+        }
+
+        entry.graph = std::move(graph);
+        entry.anyDirty = false;
+    }
+
+    void HierarchicalGrid::Update()
+    {
+        for (auto& [extents, entry] : graphs)
+        {
+            if (entry.anyDirty) rebuild(extents, entry);
+        }
+    }
+
+    // Only builds the graph the first time these extents are asked for. Later changes wait for Update.
+    std::shared_ptr<const HierarchicalGrid::AbstractGraph> HierarchicalGrid::GetGraph(const GridSquare extents)
+    {
+        auto& entry = graphs[extents];
+        if (!entry.graph) rebuild(extents, entry);
+        return entry.graph;
+    }
+
+    // Finds the gaps that can be crossed into the neighbouring cluster
+    void HierarchicalGrid::addEntrances(
+        Cluster& cluster,
+        const GridSquare extents,
+        const GridSquare first,
+        const GridSquare step,
+        const GridSquare outwards,
+        const int length) const
+    {
+        const GridSquare gridMin{0, 0};
+        const GridSquare gridMax{slices, slices};
+
+        auto squareAt = [&](const int i) {
+            return GridSquare{first.row + step.row * i, first.col + step.col * i};
+        };
+
+        auto addNode = [&](const GridSquare inside) {
+            const int idx = gridIndex(inside);
+            if (std::ranges::find(cluster.nodes, idx) == cluster.nodes.end())
+            {
+                cluster.nodes.push_back(idx);
+            }
+            cluster.edges[idx].push_back({gridIndex(inside + outwards), 1.0});
+        };
+
+        int runStart = -1;
+        for (int i = 0; i <= length; ++i)
+        {
+            bool open = false;
+            if (i < length)
+            {
+                const auto inside = squareAt(i);
+                open = isOpen(inside, extents, gridMin, gridMax) &&
+                       isOpen(inside + outwards, extents, gridMin, gridMax);
+            }
+
+            if (open && runStart < 0)
+            {
+                runStart = i;
+            }
+            else if (!open && runStart >= 0)
+            {
+                const int runEnd = i - 1;
+                if (runEnd - runStart + 1 < WIDE_ENTRANCE)
+                {
+                    addNode(squareAt((runStart + runEnd) / 2));
+                }
+                else
+                {
+                    addNode(squareAt(runStart));
+                    addNode(squareAt(runEnd));
+                }
+                runStart = -1;
+            }
+        }
+    }
+
+    // Clusters either side of a border scan the same squares, so they agree on its entrances
+    std::shared_ptr<const HierarchicalGrid::Cluster> HierarchicalGrid::buildCluster(
+        const GridSquare extents, const int clusterIdx) const
+    {
+        auto cluster = std::make_shared<Cluster>();
+
+        const auto min = clusterMin(clusterIdx);
+        const auto max = clusterMax(clusterIdx);
+        const int height = max.row - min.row;
+        const int width = max.col - min.col;
+
+        if (min.row > 0) addEntrances(*cluster, extents, min, {0, 1}, {-1, 0}, width);
+        if (max.row < slices) addEntrances(*cluster, extents, {max.row - 1, min.col}, {0, 1}, {1, 0}, width);
+        if (min.col > 0) addEntrances(*cluster, extents, min, {1, 0}, {0, -1}, height);
+        if (max.col < slices) addEntrances(*cluster, extents, {min.row, max.col - 1}, {1, 0}, {0, 1}, height);
+
+        std::vector<AbstractEdge> reachable;
+        for (const int node : cluster->nodes)
+        {
+            reachable.clear();
+            connectToCluster(cluster->nodes, extents, clusterIdx, {node / slices, node % slices}, reachable);
+            auto& edges = cluster->edges[node];
+            for (const auto& edge : reachable)
+            {
+                if (edge.to != node)
+                {
+                    edges.push_back(edge);
+                }
+            }
+        }
+
+        return cluster;
+    }
+
+    // Same step costs as jumpPointSearch, so refining an edge matches its planned cost
+    void HierarchicalGrid::connectToCluster(
+        const std::vector<int>& nodes,
+        const GridSquare extents,
+        const int clusterIdx,
+        const GridSquare square,
+        std::vector<AbstractEdge>& out) const
+    {
+        const auto min = clusterMin(clusterIdx);
+        const auto max = clusterMax(clusterIdx);
+
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
+
+        context.Visit(gridIndex(square), square);
+        context.Push(0, square);
+
+        while (!context.HeapEmpty())
+        {
+            const auto [priority, current, cost] = context.Pop();
+            if (cost > context.CostSoFar(gridIndex(current)))
+            {
+                continue; // Stale entry, a cheaper route to this square has already been expanded
+            }
+
+            for (const auto& [dirRow, dirCol] : NavigationGridView::DIRECTIONS)
+            {
+                const GridSquare next = {current.row + dirRow, current.col + dirCol};
+                if (!isOpen(next, extents, min, max)) continue;
+
+                const double newCost = cost + octileDistance(current, next);
+                const int idx = gridIndex(next);
+                if (!context.IsVisited(idx) || newCost < context.CostSoFar(idx))
+                {
+                    context.Visit(idx, current, newCost);
+                    context.Push(newCost, next, newCost);
+                }
+            }
+        }
+
+        for (const int node : nodes)
+        {
+            if (context.IsVisited(node))
+            {
+                out.push_back({node, context.CostSoFar(node)});
+            }
+        }
+    }
+
+    // Appends the squares after "from" to "path"
+    bool HierarchicalGrid::appendSegment(
+        const GridSquare from,
+        const GridSquare to,
+        const GridSquare extents,
+        const GridSquare minRange,
+        const GridSquare maxRange,
+        std::vector<GridSquare>& path) const
+    {
+        if (from == to) return true;
+        if (!navigationGrid->JumpPointSearch(from, to, extents, minRange, maxRange)) return false;
+
+        const auto& context = PathfindingContext::ThreadLocal();
+        const auto segmentStart = path.size();
+        for (GridSquare square = to; square != from;
+             square = context.CameFrom(gridIndex(square)))
+        {
+            path.push_back(square);
+        }
+        std::reverse(path.begin() + static_cast<std::ptrdiff_t>(segmentStart), path.end());
+        return true;
+    }
+
+    void HierarchicalGrid::Init(const int _slices)
+    {
+        slices = _slices;
+        clustersPerSide = (slices + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+        graphs.clear();
+    }
+
+    void HierarchicalGrid::MarkDirty(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        if (slices == 0) return;
+
+        for (auto& [extents, entry] : graphs)
+        {
+            // Occupancy affects everything within "extents", and clusters read one square past their border
+            const int margin = std::max(extents.row, extents.col) + 1;
+            const int minRow = std::max(0, minSquare.row - margin) / CLUSTER_SIZE;
+            const int minCol = std::max(0, minSquare.col - margin) / CLUSTER_SIZE;
+            const int maxRow = std::min(slices - 1, maxSquare.row + margin) / CLUSTER_SIZE;
+            const int maxCol = std::min(slices - 1, maxSquare.col + margin) / CLUSTER_SIZE;
+
+            entry.anyDirty = true;
+            for (int row = minRow; row <= maxRow; ++row)
+            {
+                for (int col = minCol; col <= maxCol; ++col)
+                {
+                    entry.dirty[row * clustersPerSide + col] = true;
+                }
+            }
+        }
+    }
+
+    bool HierarchicalGrid::FindPath(
+        const AbstractGraph& graph,
+        const GridSquare start,
+        const GridSquare finish,
+        const GridSquare extents,
+        std::vector<GridSquare>& path) const
+    {
+        const GridSquare gridMin{0, 0};
+        const GridSquare gridMax{slices, slices};
+
+        path.assign(1, start);
+
+        const int startCluster = clusterIndex(start);
+        const int finishCluster = clusterIndex(finish);
+        const auto startClusterMin = clusterMin(startCluster);
+        const auto finishClusterMin = clusterMin(finishCluster);
+
+        // Close enough that the abstract graph would not save anything
+        if (std::abs(startClusterMin.row - finishClusterMin.row) <= CLUSTER_SIZE &&
+            std::abs(startClusterMin.col - finishClusterMin.col) <= CLUSTER_SIZE)
+        {
+            return appendSegment(start, finish, extents, gridMin, gridMax, path);
+        }
+
+        // Temporarily link the start and finish to the entrances of their clusters
+        std::vector<AbstractEdge> startEdges;
+        std::vector<AbstractEdge> finishEdges;
+        connectToCluster(graph.clusters[startCluster]->nodes, extents, startCluster, start, startEdges);
+        connectToCluster(graph.clusters[finishCluster]->nodes, extents, finishCluster, finish, finishEdges);
+        std::unordered_map<int, double> finishCosts;
+        for (const auto& edge : finishEdges)
+        {
+            finishCosts.emplace(edge.to, edge.cost);
+        }
+
+        auto& context = PathfindingContext::ThreadLocal();
+        context.Reset(static_cast<size_t>(slices) * slices);
+
+        const int startIdx = gridIndex(start);
+        const int finishIdx = gridIndex(finish);
+        context.Visit(startIdx, start);
+        context.Push(octileDistance(start, finish), start);
+
+        auto relax = [&](const GridSquare current, const int to, const double edgeCost) {
+            const double newCost = context.CostSoFar(gridIndex(current)) + edgeCost;
+            if (!context.IsVisited(to) || newCost < context.CostSoFar(to))
+            {
+                const GridSquare next = {to / slices, to % slices};
+                context.Visit(to, current, newCost);
+                context.Push(newCost + octileDistance(next, finish), next, newCost);
+            }
+        };
+
+        bool routeFound = false;
+        while (!context.HeapEmpty())
+        {
+            const auto current = context.Pop().square;
+            const int idx = gridIndex(current);
+            if (idx == finishIdx)
+            {
+                routeFound = true;
+                break;
+            }
+
+            if (idx == startIdx)
+            {
+                for (const auto& edge : startEdges)
+                {
+                    relax(current, edge.to, edge.cost);
+                }
+            }
+            const auto& cluster = *graph.clusters[clusterIndex(current)];
+            if (const auto it = cluster.edges.find(idx); it != cluster.edges.end())
+            {
+                for (const auto& edge : it->second)
+                {
+                    relax(current, edge.to, edge.cost);
+                }
+            }
+            if (const auto it = finishCosts.find(idx); it != finishCosts.end())
+            {
+                relax(current, finishIdx, it->second);
+            }
+        }
+
+        // Callers check the finish is reachable first (see ConnectivityMap), so this only covers the few routes
+        // the abstract graph misses (e.g., clusters edited since the last Update)
+        if (!routeFound)
+        {
+            return appendSegment(start, finish, extents, gridMin, gridMax, path);
+        }
+
+        std::vector<GridSquare> route;
+        for (GridSquare square = finish; square != start;
+             square = context.CameFrom(gridIndex(square)))
+        {
+            route.push_back(square);
+        }
+        route.push_back(start);
+        std::ranges::reverse(route);
+
+        for (size_t i = 0; i + 1 < route.size(); ++i)
+        {
+            const auto from = route[i];
+            const auto to = route[i + 1];
+            const int cluster = clusterIndex(from);
+            if (cluster != clusterIndex(to))
+            {
+                path.push_back(to); // Crossing an entrance, always a single step
+                continue;
+            }
+            if (!appendSegment(from, to, extents, clusterMin(cluster), clusterMax(cluster), path))
+            {
+                path.assign(1, start);
+                return appendSegment(start, finish, extents, gridMin, gridMax, path);
+            }
+        }
+
+        // Joined segments can double back around an entrance
+        context.Reset(static_cast<size_t>(slices) * slices);
+        size_t write = 0;
+        for (size_t read = 0; read < path.size(); ++read)
+        {
+            const auto square = path[read];
+            const int idx = gridIndex(square);
+            if (context.IsVisited(idx))
+            {
+                const auto firstVisit = static_cast<size_t>(context.CostSoFar(idx));
+                if (firstVisit < write && path[firstVisit] == square)
+                {
+                    write = firstVisit + 1;
+                    continue;
+                }
+            }
+            context.Visit(idx, square, static_cast<double>(write));
+            path[write++] = square;
+        }
+        path.resize(write);
+
+        return true;
+    }
+
+    HierarchicalGrid::HierarchicalGrid(const NavigationGridView* _navigationGrid)
+        : navigationGrid(_navigationGrid)
+    {
+    }
+} // namespace sage
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridView;
+
+    // HPA* abstraction over the navigation grid, one graph per extents. The graph only reads static occupancy;
+    // moving actors are seen when a route is refined. Dirty clusters are rebuilt by Update, not by queries.
+    class HierarchicalGrid
+    {
+      public:
+        struct AbstractEdge
+        {
+            int to; // Grid index of the node at the other end of the edge
+            double cost;
+        };
+
+        struct Cluster
+        {
+            std::vector<int> nodes; // Grid indices of this cluster's entrances
+            std::unordered_map<int, std::vector<AbstractEdge>> edges;
+        };
+
+        // Never modified once published, so workers can search it while clusters are rebuilt
+        struct AbstractGraph
+        {
+            GridSquare extents{};
+            std::vector<std::shared_ptr<const Cluster>> clusters;
+        };
+
+      private:
+        struct GraphEntry
+        {
+            std::shared_ptr<const AbstractGraph> graph;
+            std::vector<uint8_t> dirty; // By cluster
+            bool anyDirty = true;
+        };
+
+        const NavigationGridView* navigationGrid;
+        int slices = 0;
+        int clustersPerSide = 0;
+        std::map<GridSquare, GraphEntry> graphs; // Keyed by extents
+
+        [[nodiscard]] int gridIndex(GridSquare square) const;
+        [[nodiscard]] int clusterIndex(GridSquare square) const;
+        [[nodiscard]] GridSquare clusterMin(int cluster) const;
+        [[nodiscard]] GridSquare clusterMax(int cluster) const;
+        [[nodiscard]] bool isOpen(
+            GridSquare square, GridSquare extents, GridSquare minRange, GridSquare maxRange) const;
+        [[nodiscard]] std::shared_ptr<const Cluster> buildCluster(GridSquare extents, int cluster) const;
+        void rebuild(GridSquare extents, GraphEntry& entry) const;
+        void addEntrances(
+            Cluster& cluster,
+            GridSquare extents,
+            GridSquare first,
+            GridSquare step,
+            GridSquare outwards,
+            int length) const;
+        void connectToCluster(
+            const std::vector<int>& nodes,
+            GridSquare extents,
+            int cluster,
+            GridSquare square,
+            std::vector<AbstractEdge>& out) const;
+        bool appendSegment(
+            GridSquare from,
+            GridSquare to,
+            GridSquare extents,
+            GridSquare minRange,
+            GridSquare maxRange,
+            std::vector<GridSquare>& path) const;
+
+      public:
+        static constexpr int CLUSTER_SIZE = 16;
+
+        void Init(int _slices);
+        // Inclusive range
+        void MarkDirty(GridSquare minSquare, GridSquare maxSquare);
+        // Rebuilds the dirty clusters of every graph. Main thread only.
+        void Update();
+        // Main thread only
+        [[nodiscard]] std::shared_ptr<const AbstractGraph> GetGraph(GridSquare extents);
+        // Returns false if no route was found. Does not check that the finish is reachable at all.
+        bool FindPath(
+            const AbstractGraph& graph,
+            GridSquare start,
+            GridSquare finish,
+            GridSquare extents,
+            std::vector<GridSquare>& path) const;
+
+        explicit HierarchicalGrid(const NavigationGridView* _navigationGrid);
+    };
+} // namespace sage
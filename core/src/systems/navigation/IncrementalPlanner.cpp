@@ -0,0 +1,338 @@
+#include "IncrementalPlanner.hpp"
+
+#include "NavigationGridView.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <span>
+
+namespace sage
+{
+    namespace
+    {
+        // Leaves headroom so that INF plus a step or heuristic cost cannot overflow
+        constexpr int32_t INF = std::numeric_limits<int32_t>::max() / 4;
+        constexpr int32_t STRAIGHT_COST = 10;
+        constexpr int32_t DIAGONAL_COST = 14;
+        constexpr std::array<GridSquare, 8> neighbours = {
+            {{1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+
+        int32_t octileCost(const GridSquare a, const GridSquare b)
+        {
+            const int dRow = std::abs(a.row - b.row);
+            const int dCol = std::abs(a.col - b.col);
+            return STRAIGHT_COST * std::max(dRow, dCol) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dRow, dCol);
+        }
+
+        int32_t addCost(const int32_t a, const int32_t b)
+        {
+            return std::min(a + b, INF);
+        }
+    } // namespace
+
+    int IncrementalPlanner::cellIndex(const GridSquare square) const
+    {
+        return (square.row - minRange.row) * width + (square.col - minRange.col);
+    }
+
+    GridSquare IncrementalPlanner::cellSquare(const int cell) const
+    {
+        return {minRange.row + cell / width, minRange.col + cell % width};
+    }
+
+    // Cost of stepping between two neighbouring cells, or INF if "to" cannot be entered.
+    IncrementalPlanner::Cost IncrementalPlanner::stepCost(const int from, const int to) const
+    {
+        if (!walkable[to]) return INF;
+        const auto a = cellSquare(from);
+        const auto b = cellSquare(to);
+        return a.row != b.row && a.col != b.col ? DIAGONAL_COST : STRAIGHT_COST;
+    }
+
+    IncrementalPlanner::Key IncrementalPlanner::calculateKey(const int cell) const
+    {
+        const Cost m = std::min(g[cell], rhs[cell]);
+        return {m + octileCost(last, cellSquare(cell)) + km, m};
+    }
+
+    // Discards stale entries on the way
+    IncrementalPlanner::Key IncrementalPlanner::topKey()
+    {
+        while (!open.empty())
+        {
+            const auto& top = open.front();
+            if (inOpen[top.cell] && openKey[top.cell] == top.key) return top.key;
+            std::ranges::pop_heap(open, std::greater<>{});
+            open.pop_back();
+        }
+        return {INF, INF};
+    }
+
+    void IncrementalPlanner::push(const int cell)
+    {
+        inOpen[cell] = true;
+        openKey[cell] = calculateKey(cell);
+        open.push_back({openKey[cell], cell});
+        std::ranges::push_heap(open, std::greater<>{});
+    }
+
+    void IncrementalPlanner::updateVertex(const int cell)
+    {
+        const auto square = cellSquare(cell);
+        if (square != goal)
+        {
+            Cost best = INF;
+            for (const auto& dir : neighbours)
+            {
+                const auto next = square + dir;
+                if (!Contains(next)) continue;
+                const int nextCell = cellIndex(next);
+                best = std::min(best, addCost(stepCost(cell, nextCell), g[nextCell]));
+            }
+            rhs[cell] = best;
+        }
+
+        if (g[cell] != rhs[cell])
+        {
+            push(cell);
+        }
+        else
+        {
+            inOpen[cell] = false;
+        }
+    }
+
+    void IncrementalPlanner::computeShortestPath(const int startCell)
+    {
+        const size_t maxIterations = g.size() * 16;
+        for (size_t i = 0; i < maxIterations; ++i)
+        {
+            const auto top = topKey();
+            if (open.empty() || (!(top < calculateKey(startCell)) && rhs[startCell] == g[startCell])) break;
+
+            const int cell = open.front().cell;
+            std::ranges::pop_heap(open, std::greater<>{});
+            open.pop_back();
+            inOpen[cell] = false;
+            ++expandedNodes;
+
+            if (top < calculateKey(cell))
+            {
+                push(cell);
+                continue;
+            }
+
+            const auto square = cellSquare(cell);
+            if (g[cell] > rhs[cell])
+            {
+                g[cell] = rhs[cell];
+            }
+            else
+            {
+                g[cell] = INF;
+                updateVertex(cell);
+            }
+            for (const auto& dir : neighbours)
+            {
+                if (const auto prev = square + dir; Contains(prev))
+                {
+                    updateVertex(cellIndex(prev));
+                }
+            }
+        }
+    }
+
+    // Compares against the occupancy copy from the last Replan, inclusive range
+    void IncrementalPlanner::applyOccupancyChanges(
+        const NavigationGridView& navigationGrid, GridSquare minSquare, GridSquare maxSquare)
+    {
+        minSquare = {std::max(minSquare.row, occupancyMin.row), std::max(minSquare.col, occupancyMin.col)};
+        maxSquare = {std::min(maxSquare.row, occupancyMax.row - 1), std::min(maxSquare.col, occupancyMax.col - 1)};
+        const int occupancyWidth = occupancyMax.col - occupancyMin.col;
+        for (int row = minSquare.row; row <= maxSquare.row; ++row)
+        {
+            for (int col = minSquare.col; col <= maxSquare.col; ++col)
+            {
+                const GridSquare square{row, col};
+                const uint8_t occupied = navigationGrid.IsOccupied(square);
+                auto& previous =
+                    occupancy[(row - occupancyMin.row) * occupancyWidth + (col - occupancyMin.col)];
+                if (occupied == previous) continue;
+                previous = occupied;
+                ++changedSquares;
+
+                // checkExtents covers [cell - extents, cell + extents)
+                const GridSquare min{
+                    std::max(std::min(row, row - extents.row + 1), minRange.row),
+                    std::max(std::min(col, col - extents.col + 1), minRange.col)};
+                const GridSquare max{
+                    std::min(std::max(row, row + extents.row), maxRange.row - 1),
+                    std::min(std::max(col, col + extents.col), maxRange.col - 1)};
+                for (int cellRow = min.row; cellRow <= max.row; ++cellRow)
+                {
+                    for (int cellCol = min.col; cellCol <= max.col; ++cellCol)
+                    {
+                        const GridSquare cellSq{cellRow, cellCol};
+                        const int cell = cellIndex(cellSq);
+                        const uint8_t nowWalkable =
+                            navigationGrid.IsWalkable(cellSq, extents, minRange, maxRange);
+                        if (nowWalkable == walkable[cell]) continue;
+                        walkable[cell] = nowWalkable;
+                        for (const auto& dir : neighbours)
+                        {
+                            if (const auto prev = cellSq + dir; Contains(prev))
+                            {
+                                updateVertex(cellIndex(prev));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Compares the whole window if the grid dropped some changes
+    void IncrementalPlanner::applyOccupancyChanges(const NavigationGridView& navigationGrid)
+    {
+        changedSquares = 0;
+        if (std::span<const OccupancyChange> changes;
+            navigationGrid.GetOccupancyChangesSince(occupancyChangeCount, changes))
+        {
+            for (const auto& [min, max] : changes)
+            {
+                applyOccupancyChanges(navigationGrid, min, max);
+            }
+        }
+        else
+        {
+            applyOccupancyChanges(navigationGrid, occupancyMin, occupancyMax - GridSquare{1, 1});
+        }
+        occupancyChangeCount = navigationGrid.GetOccupancyChangeCount();
+    }
+
+    bool IncrementalPlanner::Contains(const GridSquare square) const
+    {
+        return NavigationGridView::CheckWithinBounds(square, minRange, maxRange);
+    }
+
+    bool IncrementalPlanner::CanReplan(
+        const GridSquare start, const GridSquare _goal, const GridSquare _extents) const
+    {
+        return !g.empty() && goal == _goal && extents == _extents && Contains(start);
+    }
+
+    void IncrementalPlanner::Init(
+        const NavigationGridView& navigationGrid,
+        const GridSquare start,
+        const GridSquare _goal,
+        const GridSquare _extents,
+        const GridSquare _minRange,
+        const GridSquare _maxRange)
+    {
+        goal = _goal;
+        extents = _extents;
+        minRange = _minRange;
+        maxRange = _maxRange;
+        last = start;
+        km = 0;
+        width = maxRange.col - minRange.col;
+
+        const auto cells = static_cast<size_t>(maxRange.row - minRange.row) * width;
+        g.assign(cells, INF);
+        rhs.assign(cells, INF);
+        walkable.assign(cells, false);
+        inOpen.assign(cells, false);
+        openKey.assign(cells, {INF, INF});
+        open.clear();
+
+        for (int row = minRange.row; row < maxRange.row; ++row)
+        {
+            for (int col = minRange.col; col < maxRange.col; ++col)
+            {
+                walkable[cellIndex({row, col})] =
+                    navigationGrid.IsWalkable({row, col}, extents, minRange, maxRange);
+            }
+        }
+
+        occupancyMin = {
+            std::max(minRange.row - extents.row, 0), std::max(minRange.col - extents.col, 0)};
+        occupancyMax = {
+            std::min(maxRange.row + extents.row, navigationGrid.GetSlices()),
+            std::min(maxRange.col + extents.col, navigationGrid.GetSlices())};
+        occupancy.resize(
+            static_cast<size_t>(occupancyMax.row - occupancyMin.row) * (occupancyMax.col - occupancyMin.col));
+        const int occupancyWidth = occupancyMax.col - occupancyMin.col;
+        for (int row = occupancyMin.row; row < occupancyMax.row; ++row)
+        {
+            for (int col = occupancyMin.col; col < occupancyMax.col; ++col)
+            {
+                occupancy[(row - occupancyMin.row) * occupancyWidth + (col - occupancyMin.col)] =
+                    navigationGrid.IsOccupied({row, col});
+            }
+        }
+
+        occupancyChangeCount = navigationGrid.GetOccupancyChangeCount();
+
+        if (!Contains(goal)) return;
+        rhs[cellIndex(goal)] = 0;
+        push(cellIndex(goal));
+    }
+
+    bool IncrementalPlanner::Replan(
+        const NavigationGridView& navigationGrid, const GridSquare start, std::vector<GridSquare>& squares)
+    {
+        expandedNodes = 0;
+        if (g.empty() || !Contains(start) || !Contains(goal)) return false;
+
+        km += octileCost(last, start);
+        last = start;
+        applyOccupancyChanges(navigationGrid);
+
+        const int startCell = cellIndex(start);
+        computeShortestPath(startCell);
+        if (g[startCell] == INF) return false;
+
+        // Walk downhill from the start
+        squares.clear();
+        squares.push_back(start);
+        GridSquare current = start;
+        while (current != goal)
+        {
+            if (squares.size() > g.size()) return false;
+
+            const int cell = cellIndex(current);
+            Cost best = INF;
+            GridSquare bestSquare{};
+            for (const auto& dir : neighbours)
+            {
+                const auto next = current + dir;
+                if (!Contains(next)) continue;
+                const int nextCell = cellIndex(next);
+                if (const Cost cost = addCost(stepCost(cell, nextCell), g[nextCell]); cost < best)
+                {
+                    best = cost;
+                    bestSquare = next;
+                }
+            }
+            if (best == INF) return false;
+
+            current = bestSquare;
+            squares.push_back(current);
+        }
+
+        return true;
+    }
+
+    int IncrementalPlanner::ExpandedNodes() const
+    {
+        return expandedNodes;
+    }
+
+    int IncrementalPlanner::ChangedSquares() const
+    {
+        return changedSquares;
+    }
+} // namespace sage
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridView;
+
+    // D* Lite over a fixed window, repairing only what changed since the last Replan. Costs are integers so
+    // that keys compare exactly.
+    class IncrementalPlanner
+    {
+        using Cost = int32_t;
+        using Key = std::pair<Cost, Cost>;
+
+        struct QueueEntry
+        {
+            Key key;
+            int cell;
+
+            bool operator>(const QueueEntry& other) const
+            {
+                return key > other.key;
+            }
+        };
+
+        GridSquare goal{-1, -1};
+        GridSquare extents{};
+        GridSquare minRange{};
+        GridSquare maxRange{}; // Exclusive
+        GridSquare last{};     // Start square at the previous Replan
+        int width = 0;
+        Cost km = 0;
+        int expandedNodes = 0;
+        int changedSquares = 0;
+
+        std::vector<Cost> g;
+        std::vector<Cost> rhs;
+        std::vector<uint8_t> walkable;
+        std::vector<QueueEntry> open; // Binary heap. Entries are stale unless they match "openKey".
+        std::vector<uint8_t> inOpen;
+        std::vector<Key> openKey;
+
+        // Covers the window plus the extents either side
+        GridSquare occupancyMin{};
+        GridSquare occupancyMax{}; // Exclusive
+        std::vector<uint8_t> occupancy;
+        uint64_t occupancyChangeCount = 0;
+
+        [[nodiscard]] int cellIndex(GridSquare square) const;
+        [[nodiscard]] GridSquare cellSquare(int cell) const;
+        [[nodiscard]] Cost stepCost(int from, int to) const;
+        [[nodiscard]] Key calculateKey(int cell) const;
+        [[nodiscard]] Key topKey();
+        void push(int cell);
+        void updateVertex(int cell);
+        void computeShortestPath(int startCell);
+        void applyOccupancyChanges(
+            const NavigationGridView& navigationGrid, GridSquare minSquare, GridSquare maxSquare);
+        void applyOccupancyChanges(const NavigationGridView& navigationGrid);
+
+      public:
+        [[nodiscard]] bool Contains(GridSquare square) const;
+        [[nodiscard]] bool CanReplan(GridSquare start, GridSquare _goal, GridSquare _extents) const;
+        void Init(
+            const NavigationGridView& navigationGrid,
+            GridSquare start,
+            GridSquare _goal,
+            GridSquare _extents,
+            GridSquare _minRange,
+            GridSquare _maxRange);
+        // False if there is no path
+        bool Replan(
+            const NavigationGridView& navigationGrid, GridSquare start, std::vector<GridSquare>& squares);
+        [[nodiscard]] int ExpandedNodes() const;
+        [[nodiscard]] int ChangedSquares() const;
+    };
+} // namespace sage
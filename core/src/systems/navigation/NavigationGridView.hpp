@@ -0,0 +1,52 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace sage
+{
+    // Squares between min and max (inclusive) whose combined occupancy may have changed.
+    struct OccupancyChange
+    {
+        GridSquare min;
+        GridSquare max;
+    };
+
+    // The occupancy and walkability of the navigation grid, as read by the navigation modules (see
+    // NavigationGridSystem for the rules).
+    class NavigationGridView
+    {
+      public:
+        static constexpr std::array<std::pair<int, int>, 8> DIRECTIONS = {
+            {{1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+
+        [[nodiscard]] static bool CheckWithinBounds(
+            const GridSquare square, const GridSquare minRange, const GridSquare maxRange)
+        {
+            return minRange.row <= square.row && square.row < maxRange.row && minRange.col <= square.col &&
+                   square.col < maxRange.col;
+        }
+
+        [[nodiscard]] virtual int GetSlices() const = 0;
+        [[nodiscard]] virtual bool IsOccupied(GridSquare square) const = 0;
+        [[nodiscard]] virtual bool IsWalkable(
+            GridSquare square, GridSquare extents, GridSquare minRange, GridSquare maxRange) const = 0;
+        // Only reads the static layer, so squares covered by moving actors count as free.
+        [[nodiscard]] virtual bool IsStaticallyWalkable(GridSquare square, GridSquare extents) const = 0;
+        // Leaves the result in PathfindingContext::ThreadLocal.
+        virtual bool JumpPointSearch(
+            GridSquare start, GridSquare finish, GridSquare extents, GridSquare minRange, GridSquare maxRange)
+            const = 0;
+        [[nodiscard]] virtual uint64_t GetOccupancyChangeCount() const = 0;
+        // The changes since GetOccupancyChangeCount returned "count". False if some have since been dropped.
+        [[nodiscard]] virtual bool GetOccupancyChangesSince(
+            uint64_t count, std::span<const OccupancyChange>& changes) const = 0;
+
+      protected:
+        ~NavigationGridView() = default;
+    };
+} // namespace sage
@@ -0,0 +1,135 @@
+#include "NearestWalkableMap.hpp"
+
+#include "NavigationGridView.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace sage
+{
+    namespace
+    {
+        constexpr GridSquare NO_SQUARE{-1, -1};
+        constexpr std::array<GridSquare, 8> neighbours = {
+            {{1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+    } // namespace
+
+    // BFS from every walkable square within SEARCH_RADIUS of the region, which matches a BFS over the whole grid
+    void NearestWalkableMap::fillRegion(Field& field, const int region)
+    {
+        const GridSquare regionMin{
+            (region / regionsPerSide) * REGION_SIZE, (region % regionsPerSide) * REGION_SIZE};
+        const GridSquare regionMax{
+            std::min(regionMin.row + REGION_SIZE, slices), std::min(regionMin.col + REGION_SIZE, slices)};
+        const GridSquare windowMin{
+            std::max(regionMin.row - SEARCH_RADIUS, 0), std::max(regionMin.col - SEARCH_RADIUS, 0)};
+        const GridSquare windowMax{
+            std::min(regionMax.row + SEARCH_RADIUS, slices), std::min(regionMax.col + SEARCH_RADIUS, slices)};
+        const int width = windowMax.col - windowMin.col;
+        const int height = windowMax.row - windowMin.row;
+
+        windowNearest.assign(static_cast<size_t>(width) * height, NO_SQUARE);
+        frontier.clear();
+        for (int row = windowMin.row; row < windowMax.row; ++row)
+        {
+            for (int col = windowMin.col; col < windowMax.col; ++col)
+            {
+                if (navigationGrid->IsWalkable({row, col}, field.extents, {0, 0}, {slices, slices}))
+                {
+                    const int cell = (row - windowMin.row) * width + (col - windowMin.col);
+                    windowNearest[cell] = {row, col};
+                    frontier.push_back(cell);
+                }
+            }
+        }
+
+        // Each layer of the BFS is one step further (in Chebyshev distance) from the nearest walkable square
+        for (int distance = 1; distance <= SEARCH_RADIUS && !frontier.empty(); ++distance)
+        {
+            nextFrontier.clear();
+            for (const int cell : frontier)
+            {
+                const GridSquare square{cell / width, cell % width};
+                for (const auto& dir : neighbours)
+                {
+                    const auto next = square + dir;
+                    if (next.row < 0 || next.col < 0 || next.row >= height || next.col >= width) continue;
+                    const int nextCell = next.row * width + next.col;
+                    if (windowNearest[nextCell] != NO_SQUARE) continue;
+                    windowNearest[nextCell] = windowNearest[cell];
+                    nextFrontier.push_back(nextCell);
+                }
+            }
+            std::swap(frontier, nextFrontier);
+        }
+
+        auto& nearest = field.regions[region].nearest;
+        nearest.assign(static_cast<size_t>(REGION_SIZE) * REGION_SIZE, NO_SQUARE);
+        for (int row = regionMin.row; row < regionMax.row; ++row)
+        {
+            for (int col = regionMin.col; col < regionMax.col; ++col)
+            {
+                nearest[(row - regionMin.row) * REGION_SIZE + (col - regionMin.col)] =
+                    windowNearest[(row - windowMin.row) * width + (col - windowMin.col)];
+            }
+        }
+        field.regions[region].dirty = false;
+    }
+
+    void NearestWalkableMap::Init(const int _slices)
+    {
+        slices = _slices;
+        regionsPerSide = (slices + REGION_SIZE - 1) / REGION_SIZE;
+        fields.clear();
+    }
+
+    void NearestWalkableMap::MarkDirty(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        for (auto& [extents, field] : fields)
+        {
+            // Squares whose footprint covers the change, then any region whose window reaches them
+            const int rowMargin = std::max(extents.row, 0) + SEARCH_RADIUS;
+            const int colMargin = std::max(extents.col, 0) + SEARCH_RADIUS;
+            const int minRow = std::clamp(minSquare.row - rowMargin, 0, slices - 1) / REGION_SIZE;
+            const int minCol = std::clamp(minSquare.col - colMargin, 0, slices - 1) / REGION_SIZE;
+            const int maxRow = std::clamp(maxSquare.row + rowMargin, 0, slices - 1) / REGION_SIZE;
+            const int maxCol = std::clamp(maxSquare.col + colMargin, 0, slices - 1) / REGION_SIZE;
+            for (int row = minRow; row <= maxRow; ++row)
+            {
+                for (int col = minCol; col <= maxCol; ++col)
+                {
+                    field.regions[row * regionsPerSide + col].dirty = true;
+                }
+            }
+        }
+    }
+
+    std::optional<GridSquare> NearestWalkableMap::Find(const GridSquare square, const GridSquare extents)
+    {
+        if (square.row < 0 || square.col < 0 || square.row >= slices || square.col >= slices) return std::nullopt;
+
+        auto [it, inserted] = fields.try_emplace(extents);
+        auto& field = it->second;
+        if (inserted)
+        {
+            field.extents = extents;
+            field.regions.resize(static_cast<size_t>(regionsPerSide) * regionsPerSide);
+        }
+
+        const int region = (square.row / REGION_SIZE) * regionsPerSide + square.col / REGION_SIZE;
+        if (field.regions[region].dirty)
+        {
+            fillRegion(field, region);
+        }
+
+        const auto nearest = field.regions[region].nearest[(square.row % REGION_SIZE) * REGION_SIZE +
+                                                           square.col % REGION_SIZE];
+        if (nearest == NO_SQUARE) return std::nullopt;
+        return nearest;
+    }
+
+    NearestWalkableMap::NearestWalkableMap(const NavigationGridView* _navigationGrid)
+        : navigationGrid(_navigationGrid)
+    {
+    }
+} // namespace sage
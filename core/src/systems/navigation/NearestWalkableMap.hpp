@@ -0,0 +1,52 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridView;
+
+    // Nearest square an actor of the given extents can stand on, per REGION_SIZE region, filled lazily by a
+    // multi-source BFS.
+    class NearestWalkableMap
+    {
+        struct Region
+        {
+            std::vector<GridSquare> nearest; // Per square of the region. {-1, -1} if there is no answer.
+            bool dirty = true;
+        };
+
+        struct Field
+        {
+            GridSquare extents{};
+            std::vector<Region> regions;
+        };
+
+        const NavigationGridView* navigationGrid;
+        int slices = 0;
+        int regionsPerSide = 0;
+        std::map<GridSquare, Field> fields; // Keyed by extents
+        // Scratch space for fillRegion
+        std::vector<GridSquare> windowNearest;
+        std::vector<int> frontier;
+        std::vector<int> nextFrontier;
+
+        void fillRegion(Field& field, int region);
+
+      public:
+        static constexpr int REGION_SIZE = 16;
+        static constexpr int SEARCH_RADIUS = 16;
+
+        void Init(int _slices);
+        // Inclusive range
+        void MarkDirty(GridSquare minSquare, GridSquare maxSquare);
+        // Empty if there is none within SEARCH_RADIUS
+        [[nodiscard]] std::optional<GridSquare> Find(GridSquare square, GridSquare extents);
+
+        explicit NearestWalkableMap(const NavigationGridView* _navigationGrid);
+    };
+} // namespace sage
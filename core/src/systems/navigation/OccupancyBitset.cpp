@@ -0,0 +1,35 @@
+#include "OccupancyBitset.hpp"
+
+#include <algorithm>
+
+namespace sage
+{
+    void OccupancyBitset::Init(const int slices)
+    {
+        wordsPerRow = (slices + 63) / 64;
+        words.assign(static_cast<size_t>(wordsPerRow) * slices, 0);
+    }
+
+    void OccupancyBitset::Clear()
+    {
+        std::ranges::fill(words, 0);
+    }
+
+    // FindInRow, for runs that span more than one word.
+    int OccupancyBitset::findInWords(const int row, const int minCol, const int maxCol, const bool reverse) const
+    {
+        const uint64_t* rowWords = &words[row * wordsPerRow];
+        const int firstWord = minCol / 64;
+        const int lastWord = (maxCol - 1) / 64;
+        for (int i = 0; i <= lastWord - firstWord; ++i)
+        {
+            const int word = reverse ? lastWord - i : firstWord + i;
+            const int from = word == firstWord ? minCol % 64 : 0;
+            const int to = word == lastWord ? (maxCol - 1) % 64 + 1 : 64;
+            const uint64_t bits = rowWords[word] & mask(from, to);
+            if (bits == 0) continue;
+            return word * 64 + (reverse ? 63 - std::countl_zero(bits) : std::countr_zero(bits));
+        }
+        return -1;
+    }
+} // namespace sage
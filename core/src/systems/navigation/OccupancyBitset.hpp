@@ -0,0 +1,63 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace sage
+{
+    // Occupancy packed one bit per square, each row starting on a new word
+    class OccupancyBitset
+    {
+        int wordsPerRow = 0;
+        std::vector<uint64_t> words;
+
+        // Bits from "from" up to (and excluding) "to" of a word. "from" in [0, 64), "to" in [1, 64].
+        static uint64_t mask(const int from, const int to)
+        {
+            return (~uint64_t{0} >> (64 - to)) & (~uint64_t{0} << from);
+        }
+
+        [[nodiscard]] int findInWords(int row, int minCol, int maxCol, bool reverse) const;
+
+      public:
+        void Init(int slices);
+        void Clear();
+
+        void Set(const GridSquare square, const bool occupied)
+        {
+            auto& word = words[square.row * wordsPerRow + square.col / 64];
+            const uint64_t bit = uint64_t{1} << (square.col % 64);
+            word = occupied ? word | bit : word & ~bit;
+        }
+
+        [[nodiscard]] bool Test(const GridSquare square) const
+        {
+            return words[square.row * wordsPerRow + square.col / 64] >> (square.col % 64) & 1;
+        }
+
+        // -1 if there is none
+        [[nodiscard]] int FindInRow(const int row, const int minCol, const int maxCol, const bool reverse) const
+        {
+            if (minCol >= maxCol) return -1;
+            // Most runs are within a single word, which is kept inline
+            const int word = minCol / 64;
+            if (word != (maxCol - 1) / 64) return findInWords(row, minCol, maxCol, reverse);
+            const uint64_t bits = words[row * wordsPerRow + word] & mask(minCol % 64, (maxCol - 1) % 64 + 1);
+            if (bits == 0) return -1;
+            return word * 64 + (reverse ? 63 - std::countl_zero(bits) : std::countr_zero(bits));
+        }
+
+        // The range must be inside the grid
+        [[nodiscard]] bool AnyInArea(const GridSquare min, const GridSquare max) const
+        {
+            for (int row = min.row; row < max.row; ++row)
+            {
+                if (FindInRow(row, min.col, max.col, false) >= 0) return true;
+            }
+            return false;
+        }
+    };
+} // namespace sage
@@ -0,0 +1,143 @@
+#include "PathCache.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace sage
+{
+    size_t PathCache::KeyHash::operator()(const PathCacheKey& key) const
+    {
+        size_t seed = std::hash<int>{}(key.finish.row);
+        auto combine = [&seed](const int value) {
+            seed ^= std::hash<int>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        };
+        combine(key.finish.col);
+        combine(key.extents.row);
+        combine(key.extents.col);
+        combine(static_cast<int>(key.search));
+        return seed;
+    }
+
+    bool PathCache::isCurrent(const Entry& entry) const
+    {
+        for (int row = entry.regionMin.row; row <= entry.regionMax.row; ++row)
+        {
+            for (int col = entry.regionMin.col; col <= entry.regionMax.col; ++col)
+            {
+                if (regionChangedAt[row * regionsPerSide + col] > entry.storedAt) return false;
+            }
+        }
+        return true;
+    }
+
+    void PathCache::Init(const int _slices)
+    {
+        slices = _slices;
+        regionsPerSide = (slices + REGION_SIZE - 1) / REGION_SIZE;
+        regionChangedAt.assign(static_cast<size_t>(regionsPerSide) * regionsPerSide, 0);
+        clock = 0;
+        Clear();
+    }
+
+    void PathCache::Clear()
+    {
+        entries.clear();
+        lookup.clear();
+    }
+
+    void PathCache::MarkChanged(const GridSquare minSquare, const GridSquare maxSquare)
+    {
+        if (regionsPerSide == 0) return;
+
+        ++clock;
+        const int minRow = std::clamp(minSquare.row, 0, slices - 1) / REGION_SIZE;
+        const int minCol = std::clamp(minSquare.col, 0, slices - 1) / REGION_SIZE;
+        const int maxRow = std::clamp(maxSquare.row, 0, slices - 1) / REGION_SIZE;
+        const int maxCol = std::clamp(maxSquare.col, 0, slices - 1) / REGION_SIZE;
+        for (int row = minRow; row <= maxRow; ++row)
+        {
+            for (int col = minCol; col <= maxCol; ++col)
+            {
+                regionChangedAt[row * regionsPerSide + col] = clock;
+            }
+        }
+    }
+
+    bool PathCache::Find(const PathCacheKey& key, const GridSquare start, std::vector<GridSquare>& squares)
+    {
+        const auto it = lookup.find(key);
+        if (it == lookup.end()) return false;
+
+        const auto& entry = *it->second;
+        if (!isCurrent(entry))
+        {
+            Erase(key);
+            return false;
+        }
+
+        const auto position = entry.positions.find(start.row * slices + start.col);
+        if (position == entry.positions.end()) return false;
+
+        squares.assign(entry.squares.begin() + static_cast<std::ptrdiff_t>(position->second), entry.squares.end());
+        entries.splice(entries.begin(), entries, it->second);
+        return true;
+    }
+
+    void PathCache::Insert(const PathCacheKey& key, std::vector<GridSquare> squares)
+    {
+        if (squares.empty() || regionsPerSide == 0) return;
+
+        Erase(key);
+        if (entries.size() >= capacity)
+        {
+            lookup.erase(entries.back().key);
+            entries.pop_back();
+        }
+
+        Entry entry{.key = key, .squares = std::move(squares), .positions = {}, .storedAt = clock};
+        entry.positions.reserve(entry.squares.size());
+
+        GridSquare min = entry.squares.front();
+        GridSquare max = entry.squares.front();
+        for (size_t i = 0; i < entry.squares.size(); ++i)
+        {
+            const auto& square = entry.squares[i];
+            entry.positions.emplace(square.row * slices + square.col, i);
+            min = {std::min(min.row, square.row), std::min(min.col, square.col)};
+            max = {std::max(max.row, square.row), std::max(max.col, square.col)};
+        }
+
+        // Neighbouring regions too, as a door opening next to the path is a shortcut
+        entry.regionMin = {std::max(min.row / REGION_SIZE - 1, 0), std::max(min.col / REGION_SIZE - 1, 0)};
+        entry.regionMax = {
+            std::min(max.row / REGION_SIZE + 1, regionsPerSide - 1),
+            std::min(max.col / REGION_SIZE + 1, regionsPerSide - 1)};
+
+        entries.push_front(std::move(entry));
+        lookup[key] = entries.begin();
+    }
+
+    void PathCache::Erase(const PathCacheKey& key)
+    {
+        if (const auto it = lookup.find(key); it != lookup.end())
+        {
+            entries.erase(it->second);
+            lookup.erase(it);
+        }
+    }
+
+    void PathCache::RecordHit()
+    {
+        ++stats.hits;
+    }
+
+    void PathCache::RecordMiss()
+    {
+        ++stats.misses;
+    }
+
+    const PathCacheStats& PathCache::GetStats() const
+    {
+        return stats;
+    }
+} // namespace sage
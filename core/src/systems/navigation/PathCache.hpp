@@ -0,0 +1,83 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace sage
+{
+    enum class PathSearchType
+    {
+        BFS,
+        ASTAR,
+        JUMP_POINT_SEARCH,
+        HIERARCHICAL
+    };
+
+    struct PathCacheKey
+    {
+        GridSquare finish;
+        GridSquare extents;
+        PathSearchType search;
+
+        bool operator==(const PathCacheKey& other) const
+        {
+            return finish == other.finish && extents == other.extents && search == other.search;
+        }
+    };
+
+    struct PathCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    // LRU cache of recent paths, hit when the start lies on a cached path. Entries are dropped when a nearby
+    // region changes. Moving actors are not tracked, so callers must recheck the squares.
+    class PathCache
+    {
+        struct KeyHash
+        {
+            size_t operator()(const PathCacheKey& key) const;
+        };
+
+        struct Entry
+        {
+            PathCacheKey key;
+            std::vector<GridSquare> squares;
+            std::unordered_map<int, size_t> positions; // Grid index to position in "squares"
+            GridSquare regionMin{};
+            GridSquare regionMax{};
+            uint32_t storedAt = 0;
+        };
+
+        size_t capacity = 128;
+        int slices = 0;
+        int regionsPerSide = 0;
+        uint32_t clock = 0;
+        std::vector<uint32_t> regionChangedAt;
+        std::list<Entry> entries; // Most recently used first
+        std::unordered_map<PathCacheKey, std::list<Entry>::iterator, KeyHash> lookup;
+        PathCacheStats stats;
+
+        [[nodiscard]] bool isCurrent(const Entry& entry) const;
+
+      public:
+        static constexpr int REGION_SIZE = 16;
+
+        void Init(int _slices);
+        void Clear();
+        // Inclusive range
+        void MarkChanged(GridSquare minSquare, GridSquare maxSquare);
+        bool Find(const PathCacheKey& key, GridSquare start, std::vector<GridSquare>& squares);
+        void Insert(const PathCacheKey& key, std::vector<GridSquare> squares);
+        void Erase(const PathCacheKey& key);
+        void RecordHit();
+        void RecordMiss();
+        [[nodiscard]] const PathCacheStats& GetStats() const;
+    };
+} // namespace sage
@@ -0,0 +1,77 @@
+#include "PathfindingContext.hpp"
+
+#include <algorithm>
+
+namespace sage
+{
+    namespace
+    {
+        struct Compare
+        {
+            // Whether "a" pops after "b"
+            bool operator()(const PathfindingNode& a, const PathfindingNode& b) const
+            {
+                if (a.priority != b.priority) return a.priority > b.priority;
+                if (a.cost != b.cost) return a.cost < b.cost;
+                return b.square < a.square;
+            }
+        };
+    } // namespace
+
+    void PathfindingContext::Reset(const size_t cellCount)
+    {
+        const size_t pageCount = (cellCount + PAGE_SIZE - 1) >> PAGE_BITS;
+        if (pages.size() != pageCount)
+        {
+            pages.clear();
+            pages.resize(pageCount);
+            generation = 0;
+        }
+
+        if (++generation == 0)
+        {
+            // Counter wrapped around, stale stamps could now match. Start again from clean pages.
+            for (auto& page : pages)
+            {
+                page.reset();
+            }
+            generation = 1;
+        }
+
+        for (auto& page : pages)
+        {
+            if (page && generation - page->lastUsed > PAGE_IDLE_GENERATIONS) page.reset();
+        }
+
+        heap.clear();
+        queue.clear();
+        queueHead = 0;
+        expandedNodes = 0;
+    }
+
+    void PathfindingContext::Push(const double priority, const GridSquare& square, const double cost)
+    {
+        heap.push_back({priority, square, cost});
+        std::push_heap(heap.begin(), heap.end(), Compare{});
+    }
+
+    PathfindingNode PathfindingContext::Pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), Compare{});
+        const auto node = heap.back();
+        heap.pop_back();
+        ++expandedNodes;
+        return node;
+    }
+
+    int PathfindingContext::AllocatedPageCount() const
+    {
+        return static_cast<int>(std::ranges::count_if(pages, [](const auto& page) { return page != nullptr; }));
+    }
+
+    PathfindingContext& PathfindingContext::ThreadLocal()
+    {
+        thread_local PathfindingContext context;
+        return context;
+    }
+} // namespace sage
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+namespace sage
+{
+    // Exact distance between two squares on an 8-connected grid where diagonal steps cost sqrt(2).
+    inline double octileDistance(const GridSquare a, const GridSquare b)
+    {
+        const int dRow = std::abs(a.row - b.row);
+        const int dCol = std::abs(a.col - b.col);
+        return std::max(dRow, dCol) + (std::numbers::sqrt2 - 1.0) * std::min(dRow, dCol);
+    }
+
+    struct PathfindingNode
+    {
+        double priority;
+        GridSquare square;
+        double cost; // Cost so far. Breaks ties between equal priorities (see PathfindingContext::Push).
+    };
+
+    // Per-thread scratch memory for a grid search. Buffers are cleared by bumping a generation counter.
+    // Squares are stored in pages of consecutive grid indices, allocated when a search first visits one and freed
+    // once no search has used them for a while, so memory follows the rows searches actually cover.
+    // NB: Only valid for one search at a time.
+    class PathfindingContext
+    {
+        static constexpr int PAGE_BITS = 12;
+        static constexpr int PAGE_SIZE = 1 << PAGE_BITS;
+        // Pages no search has visited in this many generations are freed at the next Reset
+        static constexpr uint32_t PAGE_IDLE_GENERATIONS = 256;
+
+        struct Page
+        {
+            std::array<uint32_t, PAGE_SIZE> visitedGeneration;
+            std::array<GridSquare, PAGE_SIZE> cameFrom;
+            std::array<double, PAGE_SIZE> costSoFar;
+            uint32_t lastUsed = 0; // Generation
+        };
+
+        uint32_t generation = 0;
+        std::vector<std::unique_ptr<Page>> pages; // Null until visited
+        std::vector<PathfindingNode> heap;
+        std::vector<GridSquare> queue;
+        size_t queueHead = 0;
+        int expandedNodes = 0;
+
+      public:
+        void Reset(size_t cellCount);
+
+        [[nodiscard]] bool IsVisited(const int idx) const
+        {
+            const auto& page = pages[idx >> PAGE_BITS];
+            return page && page->visitedGeneration[idx & (PAGE_SIZE - 1)] == generation;
+        }
+
+        void Visit(const int idx, const GridSquare& from, const double cost = 0.0)
+        {
+            auto& page = pages[idx >> PAGE_BITS];
+            if (!page) page = std::make_unique<Page>();
+            page->lastUsed = generation;
+            page->visitedGeneration[idx & (PAGE_SIZE - 1)] = generation;
+            page->cameFrom[idx & (PAGE_SIZE - 1)] = from;
+            page->costSoFar[idx & (PAGE_SIZE - 1)] = cost;
+        }
+
+        // Visited squares only
+        [[nodiscard]] const GridSquare& CameFrom(const int idx) const
+        {
+            return pages[idx >> PAGE_BITS]->cameFrom[idx & (PAGE_SIZE - 1)];
+        }
+
+        // Visited squares only
+        [[nodiscard]] double CostSoFar(const int idx) const
+        {
+            return pages[idx >> PAGE_BITS]->costSoFar[idx & (PAGE_SIZE - 1)];
+        }
+
+        [[nodiscard]] int AllocatedPageCount() const;
+
+        // Number of squares taken off the frontier since the last Reset
+        [[nodiscard]] int ExpandedNodes() const
+        {
+            return expandedNodes;
+        }
+
+        // Ties pop the highest cost so far, then the lowest square, so results never depend on push order
+        void Push(double priority, const GridSquare& square, double cost = 0.0);
+        PathfindingNode Pop();
+        [[nodiscard]] bool HeapEmpty() const
+        {
+            return heap.empty();
+        }
+
+        // FIFO frontier
+        void Enqueue(const GridSquare& square)
+        {
+            queue.push_back(square);
+        }
+        GridSquare Dequeue()
+        {
+            ++expandedNodes;
+            return queue[queueHead++];
+        }
+        [[nodiscard]] bool QueueEmpty() const
+        {
+            return queueHead == queue.size();
+        }
+
+        static PathfindingContext& ThreadLocal();
+    };
+} // namespace sage
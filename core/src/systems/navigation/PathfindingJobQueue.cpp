@@ -0,0 +1,133 @@
+#include "PathfindingJobQueue.hpp"
+
+#include "systems/NavigationGridSystem.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace sage
+{
+    void PathfindingJobQueue::workerLoop()
+    {
+        while (true)
+        {
+            QueuedJob queued;
+            {
+                std::unique_lock lock(mutex);
+                jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                queued = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            PathfindResult result{
+                queued.job.ticket,
+                queued.job.entity,
+                queued.job.destination,
+                navigationGridSystem->RunPathfindJob(queued.job, *queued.occupancy)};
+
+            std::lock_guard lock(mutex);
+            results.push_back(std::move(result));
+        }
+    }
+
+    PathfindTicket PathfindingJobQueue::Submit(PathfindJob job)
+    {
+        Cancel(job.entity);
+        job.ticket = nextTicket++;
+        if (nextTicket == NULL_PATHFIND_TICKET) ++nextTicket;
+        latestTickets[job.entity] = job.ticket;
+        pending.push_back(job);
+        return job.ticket;
+    }
+
+    void PathfindingJobQueue::Cancel(const entt::entity entity)
+    {
+        if (latestTickets.erase(entity) == 0) return;
+        std::erase_if(pending, [entity](const PathfindJob& job) { return job.entity == entity; });
+
+        std::lock_guard lock(mutex);
+        std::erase_if(jobs, [entity](const QueuedJob& queued) { return queued.job.entity == entity; });
+    }
+
+    bool PathfindingJobQueue::IsPending(const entt::entity entity) const
+    {
+        return latestTickets.contains(entity);
+    }
+
+    bool PathfindingJobQueue::HasUndispatchedJobs() const
+    {
+        return !pending.empty();
+    }
+
+    void PathfindingJobQueue::Dispatch()
+    {
+        const auto count = pending.size();
+        if (count == 0) return;
+
+        GridSquare min = pending.front().minRange;
+        GridSquare max = pending.front().maxRange;
+        for (size_t i = 1; i < count; ++i)
+        {
+            min = {std::min(min.row, pending[i].minRange.row), std::min(min.col, pending[i].minRange.col)};
+            max = {std::max(max.row, pending[i].maxRange.row), std::max(max.col, pending[i].maxRange.col)};
+        }
+        const auto occupancy = navigationGridSystem->SnapshotOccupancy(min, max);
+        {
+            std::lock_guard lock(mutex);
+            for (size_t i = 0; i < count; ++i)
+            {
+                jobs.push_back({pending.front(), occupancy});
+                pending.pop_front();
+            }
+        }
+        jobAvailable.notify_all();
+    }
+
+    void PathfindingJobQueue::Collect(const std::function<void(const PathfindResult&)>& apply)
+    {
+        {
+            std::lock_guard lock(mutex);
+            std::ranges::move(results, std::back_inserter(finished));
+            results.clear();
+        }
+
+        // Always applies at least one, so a slow result cannot hold up the rest forever
+        const auto deadline = std::chrono::steady_clock::now() + applyBudget;
+        while (!finished.empty())
+        {
+            const auto result = std::move(finished.front());
+            finished.pop_front();
+            const auto it = latestTickets.find(result.entity);
+            if (it == latestTickets.end() || it->second != result.ticket) continue;
+            latestTickets.erase(it);
+
+            apply(result);
+            if (std::chrono::steady_clock::now() >= deadline) break;
+        }
+    }
+
+    PathfindingJobQueue::~PathfindingJobQueue()
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    PathfindingJobQueue::PathfindingJobQueue(
+        const NavigationGridSystem* _navigationGridSystem, const unsigned int workerCount)
+        : navigationGridSystem(_navigationGridSystem)
+    {
+        workers.reserve(workerCount);
+        for (unsigned int i = 0; i < workerCount; ++i)
+        {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+} // namespace sage
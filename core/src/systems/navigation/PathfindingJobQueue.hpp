@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ChunkedLayer.hpp"
+#include "components/NavigationGridSquare.hpp"
+#include "HierarchicalGrid.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridSystem;
+
+    using PathfindTicket = uint32_t;
+    constexpr PathfindTicket NULL_PATHFIND_TICKET = 0;
+
+    // Resolved on the main thread, so the worker never touches the registry
+    struct PathfindJob
+    {
+        PathfindTicket ticket = NULL_PATHFIND_TICKET;
+        entt::entity entity = entt::null;
+        Vector3 destination{};
+        GridSquare start{};
+        GridSquare finish{};
+        GridSquare extents{};
+        GridSquare minRange{};
+        GridSquare maxRange{};
+        // The actor's own squares, which the search ignores
+        GridSquare ignoreMin{};
+        GridSquare ignoreMax{};
+        bool astar = false;
+        std::shared_ptr<const HierarchicalGrid::AbstractGraph> graph;
+    };
+
+    // Copied for the workers by NavigationGridSystem::SnapshotOccupancy
+    struct OccupancySnapshot
+    {
+        GridSquare min{};
+        GridSquare max{}; // Exclusive
+        uint32_t version = 0;
+        ChunkedLayer<uint8_t> occupancy; // Only the chunks overlapping the rectangle
+
+        // Squares outside the rectangle count as occupied.
+        [[nodiscard]] bool IsOccupied(const GridSquare square) const
+        {
+            if (square.row < min.row || square.col < min.col || square.row >= max.row || square.col >= max.col)
+                return true;
+            return occupancy.Get(square);
+        }
+    };
+
+    struct PathfindResult
+    {
+        PathfindTicket ticket = NULL_PATHFIND_TICKET;
+        entt::entity entity = entt::null;
+        Vector3 destination{};
+        std::vector<Vector3> path;
+    };
+
+    // Runs searches on worker threads against an occupancy snapshot taken at Dispatch. Resubmitting or cancelling
+    // supersedes an entity's previous ticket. NavigationGridSystem must outlive the queue.
+    class PathfindingJobQueue
+    {
+        struct QueuedJob
+        {
+            PathfindJob job;
+            std::shared_ptr<const OccupancySnapshot> occupancy;
+        };
+
+        const NavigationGridSystem* navigationGridSystem;
+        std::vector<std::thread> workers;
+
+        // Main thread only
+        PathfindTicket nextTicket = NULL_PATHFIND_TICKET + 1;
+        std::deque<PathfindJob> pending;
+        std::unordered_map<entt::entity, PathfindTicket> latestTickets;
+        std::deque<PathfindResult> finished; // Collected, but not yet applied
+
+        // Shared with the workers, guarded by "mutex"
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        std::deque<QueuedJob> jobs;
+        std::vector<PathfindResult> results;
+        bool stopping = false;
+
+        void workerLoop();
+
+      public:
+        // Main thread time Collect may spend applying results each frame. The searches themselves run on the
+        // workers, so applying them (e.g., curving the path, publishing events) is what costs the frame.
+        std::chrono::microseconds applyBudget{500};
+
+        PathfindTicket Submit(PathfindJob job);
+        void Cancel(entt::entity entity);
+        [[nodiscard]] bool IsPending(entt::entity entity) const;
+        [[nodiscard]] bool HasUndispatchedJobs() const;
+        void Dispatch();
+        // Applies finished results, oldest first, until applyBudget runs out. The rest wait for the next call.
+        // Drops superseded and cancelled results.
+        void Collect(const std::function<void(const PathfindResult&)>& apply);
+
+        PathfindingJobQueue(const PathfindingJobQueue&) = delete;
+        PathfindingJobQueue& operator=(const PathfindingJobQueue&) = delete;
+        ~PathfindingJobQueue();
+        PathfindingJobQueue(const NavigationGridSystem* _navigationGridSystem, unsigned int workerCount);
+    };
+} // namespace sage
@@ -0,0 +1,174 @@
+#include "TerrainChunks.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+
+namespace sage
+{
+    namespace
+    {
+        constexpr int CHUNK_AREA = TerrainChunks::CHUNK_SIZE * TerrainChunks::CHUNK_SIZE;
+    }
+
+    int TerrainChunks::chunkIndex(const GridSquare square) const
+    {
+        return square.row / CHUNK_SIZE * chunksPerSide + square.col / CHUNK_SIZE;
+    }
+
+    int TerrainChunks::squareIndex(const GridSquare square) const
+    {
+        return square.row % CHUNK_SIZE * CHUNK_SIZE + square.col % CHUNK_SIZE;
+    }
+
+    std::unique_ptr<TerrainChunks::Chunk> TerrainChunks::unpack(const int chunk) const
+    {
+        auto out = std::make_unique<Chunk>();
+        out->heights.assign(CHUNK_AREA, NAVIGATION_GRID_NO_HEIGHT);
+        out->normals.assign(CHUNK_AREA, {0, 1, 0});
+        if (source.heights.empty()) return out;
+
+        const int firstRow = chunk / chunksPerSide * CHUNK_SIZE;
+        const int firstCol = chunk % chunksPerSide * CHUNK_SIZE;
+        for (int row = firstRow; row < std::min(firstRow + CHUNK_SIZE, slices); ++row)
+        {
+            for (int col = firstCol; col < std::min(firstCol + CHUNK_SIZE, slices); ++col)
+            {
+                const size_t from = static_cast<size_t>(row) * slices + col;
+                const int to = (row - firstRow) * CHUNK_SIZE + col - firstCol;
+                out->heights[to] = source.GetHeight(from);
+                out->normals[to] = source.GetNormal(from);
+            }
+        }
+        return out;
+    }
+
+    TerrainChunks::Chunk& TerrainChunks::load(const GridSquare square)
+    {
+        auto& chunk = chunks[chunkIndex(square)];
+        if (!chunk)
+        {
+            auto unpacked = unpack(chunkIndex(square));
+            std::unique_lock lock(chunkMutex);
+            chunk = std::move(unpacked);
+        }
+        return *chunk;
+    }
+
+    void TerrainChunks::Init(const int _slices)
+    {
+        std::unique_lock lock(chunkMutex);
+        slices = _slices;
+        chunksPerSide = (slices + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        chunks.clear();
+        chunks.resize(static_cast<size_t>(chunksPerSide) * chunksPerSide);
+        source = {};
+    }
+
+    void TerrainChunks::SetSource(Heightfield heightfield)
+    {
+        assert(heightfield.slices == slices);
+        std::unique_lock lock(chunkMutex);
+        for (auto& chunk : chunks)
+        {
+            chunk.reset();
+        }
+        source = std::move(heightfield);
+    }
+
+    void TerrainChunks::LoadAll()
+    {
+        for (int chunk = 0; chunk < static_cast<int>(chunks.size()); ++chunk)
+        {
+            load({chunk / chunksPerSide * CHUNK_SIZE, chunk % chunksPerSide * CHUNK_SIZE});
+        }
+    }
+
+    void TerrainChunks::KeepLoaded(const std::vector<GridSquare>& squares, const int radius)
+    {
+        if (source.heights.empty()) return;
+
+        wanted.assign(chunks.size(), 0);
+        for (const auto& square : squares)
+        {
+            const int row = std::clamp(square.row, 0, slices - 1) / CHUNK_SIZE;
+            const int col = std::clamp(square.col, 0, slices - 1) / CHUNK_SIZE;
+            for (int r = std::max(row - radius, 0); r <= std::min(row + radius, chunksPerSide - 1); ++r)
+            {
+                for (int c = std::max(col - radius, 0); c <= std::min(col + radius, chunksPerSide - 1); ++c)
+                {
+                    wanted[r * chunksPerSide + c] = 1;
+                }
+            }
+        }
+
+        // Unpacked before taking the lock, so that workers reading the terrain are not held up
+        std::vector<std::pair<int, std::unique_ptr<Chunk>>> loaded;
+        bool unloading = false;
+        for (int chunk = 0; chunk < static_cast<int>(chunks.size()); ++chunk)
+        {
+            if (wanted[chunk] && !chunks[chunk]) loaded.emplace_back(chunk, unpack(chunk));
+            unloading |= !wanted[chunk] && chunks[chunk];
+        }
+        if (loaded.empty() && !unloading) return;
+
+        std::vector<std::unique_ptr<Chunk>> unloaded; // Freed once the lock is released
+        std::unique_lock lock(chunkMutex);
+        for (auto& [chunk, unpacked] : loaded)
+        {
+            chunks[chunk] = std::move(unpacked);
+        }
+        for (int chunk = 0; chunk < static_cast<int>(chunks.size()); ++chunk)
+        {
+            if (!wanted[chunk] && chunks[chunk]) unloaded.push_back(std::move(chunks[chunk]));
+        }
+    }
+
+    int TerrainChunks::LoadedChunkCount() const
+    {
+        std::shared_lock lock(chunkMutex);
+        return static_cast<int>(std::ranges::count_if(chunks, [](const auto& chunk) { return chunk != nullptr; }));
+    }
+
+    float TerrainChunks::GetHeight(const GridSquare square) const
+    {
+        std::shared_lock lock(chunkMutex);
+        if (const auto& chunk = chunks[chunkIndex(square)]) return chunk->heights[squareIndex(square)];
+        if (source.heights.empty()) return NAVIGATION_GRID_NO_HEIGHT;
+        return source.GetHeight(static_cast<size_t>(square.row) * slices + square.col);
+    }
+
+    Vector3 TerrainChunks::GetNormal(const GridSquare square) const
+    {
+        std::shared_lock lock(chunkMutex);
+        if (const auto& chunk = chunks[chunkIndex(square)]) return chunk->normals[squareIndex(square)];
+        if (source.normals.empty()) return {0, 1, 0};
+        return source.GetNormal(static_cast<size_t>(square.row) * slices + square.col);
+    }
+
+    float& TerrainChunks::Height(const GridSquare square)
+    {
+        return load(square).heights[squareIndex(square)];
+    }
+
+    Vector3& TerrainChunks::Normal(const GridSquare square)
+    {
+        return load(square).normals[squareIndex(square)];
+    }
+
+    void TerrainChunks::Flatten(std::vector<float>& heights, std::vector<Vector3>& normals) const
+    {
+        const size_t count = static_cast<size_t>(slices) * slices;
+        heights.resize(count);
+        normals.resize(count);
+        for (int row = 0; row < slices; ++row)
+        {
+            for (int col = 0; col < slices; ++col)
+            {
+                heights[static_cast<size_t>(row) * slices + col] = GetHeight({row, col});
+                normals[static_cast<size_t>(row) * slices + col] = GetNormal({row, col});
+            }
+        }
+    }
+} // namespace sage
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "components/NavigationGridSquare.hpp"
+#include "Heightfield.hpp"
+
+#include "raylib.h"
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace sage
+{
+    // Terrain height and normal per square, in chunks that are only allocated while loaded. With a Heightfield,
+    // unloaded chunks are read from it. Const reads are safe from the pathfinding workers.
+    // Unlike ChunkedLayer, chunks are dropped by distance rather than by content.
+    class TerrainChunks
+    {
+        struct Chunk
+        {
+            std::vector<float> heights;
+            std::vector<Vector3> normals;
+        };
+
+        int slices = 0;
+        int chunksPerSide = 0;
+        std::vector<std::unique_ptr<Chunk>> chunks; // Null while unloaded
+        Heightfield source;
+        // Held exclusively while a chunk is loaded or unloaded
+        mutable std::shared_mutex chunkMutex;
+        std::vector<uint8_t> wanted; // Scratch for KeepLoaded
+
+        [[nodiscard]] int chunkIndex(GridSquare square) const;
+        [[nodiscard]] int squareIndex(GridSquare square) const;
+        [[nodiscard]] std::unique_ptr<Chunk> unpack(int chunk) const;
+        Chunk& load(GridSquare square);
+
+      public:
+        static constexpr int CHUNK_SIZE = 64;
+
+        void Init(int _slices);
+        void SetSource(Heightfield heightfield);
+        // So that the terrain can be written from several threads
+        void LoadAll();
+        // Unloads the rest. Does nothing without a Heightfield.
+        void KeepLoaded(const std::vector<GridSquare>& squares, int radius);
+        [[nodiscard]] int LoadedChunkCount() const;
+
+        [[nodiscard]] float GetHeight(GridSquare square) const;
+        [[nodiscard]] Vector3 GetNormal(GridSquare square) const;
+        // Main thread only, unless every chunk is loaded
+        [[nodiscard]] float& Height(GridSquare square);
+        [[nodiscard]] Vector3& Normal(GridSquare square);
+        void Flatten(std::vector<float>& heights, std::vector<Vector3>& normals) const;
+    };
+} // namespace sage
@@ -200,7 +200,7 @@ namespace sage
             {
                 targetPos = registry->get<sgTransform>(ab.caster).GetWorldPos();
             }
-            AOEAtPoint(registry, ab.caster, abilityEntity, targetPos, ad.base.radius);
+            AOEAtPoint(registry, sys, ab.caster, abilityEntity, targetPos, ad.base.radius);
         }
 
         ChangeState(abilityEntity, AbilityStateEnum::IDLE);
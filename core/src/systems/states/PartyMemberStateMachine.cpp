@@ -85,7 +85,7 @@ namespace sage
             auto dest = targetMoveable.IsMoving() ? targetMoveable.GetDestination() : targetTrans.GetWorldPos();
             const auto dir = Vector3Normalize(Vector3Subtract(dest, trans.GetWorldPos()));
             dest = Vector3Subtract(dest, Vector3MultiplyByValue(dir, FOLLOW_DISTANCE));
-            sys->actorMovementSystem->PathfindToLocation(self, dest, true);
+            sys->actorMovementSystem->PathfindToLocationInGroup(self, dest, target);
         }
 
         void onTargetReached(const entt::entity self) const
@@ -92,8 +92,7 @@ namespace sage
 
             for (const auto& member : party)
             {
-                const auto& collideable = registry->get<Collideable>(member);
-                sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, false);
+                sys->navigationGridSystem->RemoveDynamicOccupant(member);
             }
 
             if (sys->actorMovementSystem->TryPathfindToLocation(self, sys->cursor->getFirstCollision().point))
@@ -118,7 +117,7 @@ namespace sage
             for (const auto& member : party)
             {
                 const auto& collideable = registry->get<Collideable>(member);
-                sys->navigationGridSystem->MarkSquareAreaOccupied(collideable.worldBoundingBox, true);
+                sys->navigationGridSystem->PlaceDynamicOccupant(member, collideable.worldBoundingBox);
             }
         }
 
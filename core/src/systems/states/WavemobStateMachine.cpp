@@ -89,22 +89,23 @@ namespace sage
             auto& collideable = registry->get<Collideable>(self);
 
             const auto& targetPos = registry->get<sgTransform>(combatable.target).GetWorldPos();
-            Vector3 direction = Vector3Subtract(targetPos, trans.GetWorldPos());
-            float distance = Vector3Distance(trans.GetWorldPos(), targetPos);
-            Vector3 normDirection = Vector3Normalize(direction);
+            float height = Vector3Subtract(collideable.localBoundingBox.max, collideable.localBoundingBox.min).y;
+            const Vector3 eye{0, height, 0};
+            const Vector3 from = Vector3Add(trans.GetWorldPos(), eye);
+            const Vector3 to = Vector3Add(targetPos, eye);
 
             Ray ray;
-            ray.position = trans.GetWorldPos();
-            ray.direction = Vector3Scale(normDirection, distance);
-            float height = Vector3Subtract(collideable.localBoundingBox.max, collideable.localBoundingBox.min).y;
-            ray.position.y = trans.GetWorldPos().y + height;
-            ray.direction.y = trans.GetWorldPos().y + height;
+            ray.position = from;
+            ray.direction = Vector3Subtract(to, from);
             trans.movementDirectionDebugLine = ray;
 
-            auto collisions =
-                sys->collisionSystem->GetCollisionsWithRay(self, ray, collideable.collisionLayer);
-
-            if (!collisions.empty() && collisions.at(0).collisionLayer != CollisionLayer::PLAYER)
+            // Only what is between us and the target blocks the line of sight, and other players do not
+            if (sys->collisionSystem->AnyCollisionWithRay(
+                    self,
+                    ray,
+                    Vector3Distance(from, to),
+                    collideable.collisionLayer,
+                    LayerBit(CollisionLayer::PLAYER)))
             {
                 // Lost line of sight, out of combat
                 combatable.target = entt::null;
@@ -116,10 +117,18 @@ namespace sage
 
         void onTargetPosUpdate(entt::entity self, entt::entity target) const
         {
-            const auto& targetPos = registry->get<sgTransform>(target).GetWorldPos();
             auto& animation = registry->get<Animation>(self);
             animation.ChangeAnimationByEnum(AnimationEnum::WALK, 2);
-            sys->actorMovementSystem->PathfindToLocation(self, targetPos);
+            // The wave only gets in its own way close to the target, so only the mobs there plan as a group
+            const auto& targetPos = registry->get<sgTransform>(target).GetWorldPos();
+            const auto& pos = registry->get<sgTransform>(self).GetWorldPos();
+            if (Vector3Distance(pos, targetPos) <
+                CooperativePlanner::WINDOW * sys->navigationGridSystem->spacing)
+            {
+                sys->actorMovementSystem->PathfindToLocationInGroup(self, targetPos, target);
+                return;
+            }
+            sys->actorMovementSystem->PathfindToTarget(self, target);
         }
 
       public:
@@ -246,8 +255,7 @@ namespace sage
             auto& combatable = registry->get<CombatableActor>(self);
             combatable.target = entt::null;
             combatable.dying = true;
-            auto& bb = registry->get<Collideable>(self).worldBoundingBox;
-            sys->navigationGridSystem->MarkSquareAreaOccupied(bb, false);
+            sys->navigationGridSystem->RemoveDynamicOccupant(self);
             auto& animation = registry->get<Animation>(self);
             animation.ChangeAnimationByEnum(AnimationEnum::DEATH, true);
             auto& state = registry->get<WavemobState>(self);
@@ -0,0 +1,137 @@
+#include "Bvh.hpp"
+
+#include <array>
+#include <numeric>
+
+namespace sage
+{
+    namespace
+    {
+        constexpr int BIN_COUNT = 12;
+        // Past this depth nodes are split at the median, bounding the traversal stack
+        constexpr int MAX_SAH_DEPTH = 32;
+
+        float axisOf(const Vector3 v, const int axis)
+        {
+            return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+        }
+
+        struct Builder
+        {
+            const std::vector<BvhBounds>& primitives;
+            const std::vector<Vector3>& centroids;
+            const uint32_t maxLeafSize;
+            std::vector<uint32_t>& order;
+            std::vector<BvhNode>& nodes;
+
+            uint32_t Build(const uint32_t begin, const uint32_t end, const int depth)
+            {
+                const auto nodeIndex = static_cast<uint32_t>(nodes.size());
+                BvhBounds bounds, centroidBounds;
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    bounds.Grow(primitives[order[i]]);
+                    centroidBounds.Grow(centroids[order[i]]);
+                }
+                nodes.push_back({bounds.min, bounds.max, begin, end - begin});
+
+                const uint32_t count = end - begin;
+                if (count <= maxLeafSize) return nodeIndex;
+
+                const uint32_t mid = split(begin, end, depth, bounds, centroidBounds);
+                if (mid == begin || mid == end) return nodeIndex;
+
+                Build(begin, mid, depth + 1);
+                const uint32_t right = Build(mid, end, depth + 1);
+                nodes[nodeIndex].first = right;
+                nodes[nodeIndex].count = 0;
+                return nodeIndex;
+            }
+
+            // Returns where the right child starts, or "begin" for a leaf
+            uint32_t split(
+                const uint32_t begin,
+                const uint32_t end,
+                const int depth,
+                const BvhBounds& bounds,
+                const BvhBounds& centroidBounds) const
+            {
+                const Vector3 extent = Vector3Subtract(centroidBounds.max, centroidBounds.min);
+                const int axis =
+                    extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+                const float axisMin = axisOf(centroidBounds.min, axis);
+                const float axisExtent = axisOf(extent, axis);
+                if (axisExtent <= 0) return depth < MAX_SAH_DEPTH ? begin : median(begin, end, axis);
+                if (depth >= MAX_SAH_DEPTH) return median(begin, end, axis);
+
+                std::array<BvhBounds, BIN_COUNT> bins{};
+                std::array<uint32_t, BIN_COUNT> binCounts{};
+                auto binOf = [&](const uint32_t primitive) {
+                    const float offset = (axisOf(centroids[primitive], axis) - axisMin) / axisExtent;
+                    return std::min(static_cast<int>(offset * BIN_COUNT), BIN_COUNT - 1);
+                };
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    const int bin = binOf(order[i]);
+                    bins[bin].Grow(primitives[order[i]]);
+                    ++binCounts[bin];
+                }
+
+                // Cost of splitting after each bin, sweeping from both sides
+                std::array<float, BIN_COUNT - 1> costs{};
+                BvhBounds left, right;
+                uint32_t leftCount = 0, rightCount = 0;
+                for (int i = 0; i < BIN_COUNT - 1; ++i)
+                {
+                    left.Grow(bins[i]);
+                    leftCount += binCounts[i];
+                    costs[i] = left.Area() * static_cast<float>(leftCount);
+                }
+                for (int i = BIN_COUNT - 1; i > 0; --i)
+                {
+                    right.Grow(bins[i]);
+                    rightCount += binCounts[i];
+                    costs[i - 1] += right.Area() * static_cast<float>(rightCount);
+                }
+                const auto best = std::ranges::min_element(costs);
+                const float leafCost = bounds.Area() * static_cast<float>(end - begin);
+                if (*best >= leafCost && end - begin <= maxLeafSize * 4) return begin;
+
+                const int splitBin = static_cast<int>(best - costs.begin());
+                auto onLeft = [&](const uint32_t primitive) { return binOf(primitive) <= splitBin; };
+                const auto mid = std::partition(order.begin() + begin, order.begin() + end, onLeft);
+                const auto result = static_cast<uint32_t>(mid - order.begin());
+                return result == begin || result == end ? median(begin, end, axis) : result;
+            }
+
+            uint32_t median(const uint32_t begin, const uint32_t end, const int axis) const
+            {
+                const uint32_t mid = begin + (end - begin) / 2;
+                std::nth_element(
+                    order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t a, uint32_t b) {
+                        return axisOf(centroids[a], axis) < axisOf(centroids[b], axis);
+                    });
+                return mid;
+            }
+        };
+    } // namespace
+
+    std::vector<BvhNode> BuildBvh(
+        const std::vector<BvhBounds>& primitives, const uint32_t maxLeafSize, std::vector<uint32_t>& order)
+    {
+        const auto count = static_cast<uint32_t>(primitives.size());
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<BvhNode> nodes;
+        if (count == 0) return nodes;
+
+        std::vector<Vector3> centroids(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            centroids[i] = Vector3Scale(Vector3Add(primitives[i].min, primitives[i].max), 0.5f);
+        }
+        nodes.reserve(count * 2 / maxLeafSize + 1);
+        Builder{primitives, centroids, maxLeafSize, order, nodes}.Build(0, count, 0);
+        return nodes;
+    }
+} // namespace sage
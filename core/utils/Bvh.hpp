@@ -0,0 +1,84 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sage
+{
+    // Bounds that start empty, and grow to fit what is added to them
+    struct BvhBounds
+    {
+        Vector3 min{
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max()};
+        Vector3 max{
+            std::numeric_limits<float>::lowest(),
+            std::numeric_limits<float>::lowest(),
+            std::numeric_limits<float>::lowest()};
+
+        void Grow(const Vector3 point)
+        {
+            min = Vector3Min(min, point);
+            max = Vector3Max(max, point);
+        }
+
+        void Grow(const BvhBounds& other)
+        {
+            min = Vector3Min(min, other.min);
+            max = Vector3Max(max, other.max);
+        }
+
+        [[nodiscard]] float Area() const
+        {
+            if (min.x > max.x) return 0;
+            const Vector3 size = Vector3Subtract(max, min);
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+    };
+
+    struct BvhNode
+    {
+        Vector3 min;
+        Vector3 max;
+        // Inner nodes have count 0, the left child follows them and "first" is the right child
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Deepest a tree built by BuildBvh can be, so traversal stacks can be fixed size.
+    constexpr int BVH_MAX_DEPTH = 64;
+
+    // Binned SAH, depth first. "order" lists the primitives as the leaves refer to them.
+    [[nodiscard]] std::vector<BvhNode> BuildBvh(
+        const std::vector<BvhBounds>& primitives, uint32_t maxLeafSize, std::vector<uint32_t>& order);
+
+    // Entry distance of the ray into the box, or infinity if it misses it (or only hits it beyond "maxT").
+    [[nodiscard]] inline float RayBoxEntry(
+        const Vector3 origin,
+        const Vector3 inverseDirection,
+        const Vector3 min,
+        const Vector3 max,
+        const float maxT)
+    {
+        const float tx1 = (min.x - origin.x) * inverseDirection.x;
+        const float tx2 = (max.x - origin.x) * inverseDirection.x;
+        float tMin = std::min(tx1, tx2);
+        float tMax = std::max(tx1, tx2);
+        const float ty1 = (min.y - origin.y) * inverseDirection.y;
+        const float ty2 = (max.y - origin.y) * inverseDirection.y;
+        tMin = std::max(tMin, std::min(ty1, ty2));
+        tMax = std::min(tMax, std::max(ty1, ty2));
+        const float tz1 = (min.z - origin.z) * inverseDirection.z;
+        const float tz2 = (max.z - origin.z) * inverseDirection.z;
+        tMin = std::max(tMin, std::min(tz1, tz2));
+        tMax = std::min(tMax, std::max(tz1, tz2));
+        if (tMax < tMin || tMax < 0 || tMin > maxT) return std::numeric_limits<float>::infinity();
+        return std::max(tMin, 0.0f);
+    }
+} // namespace sage
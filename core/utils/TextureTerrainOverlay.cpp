@@ -47,19 +47,21 @@ namespace sage
 
     void TextureTerrainOverlay::updateVertexData(Mesh& mesh, int vertexIndex, int gridRow, int gridCol) const
     {
-        const auto& gridSquares = navigationGridSystem->GetGridSquares();
-        mesh.vertices[vertexIndex * 3] = gridSquares[gridRow][gridCol]->worldPosMin.x;
-        mesh.vertices[vertexIndex * 3 + 1] = gridSquares[gridRow][gridCol]->GetTerrainHeight() +
+        const GridSquare square{gridRow, gridCol};
+        Vector3 worldPosMin{};
+        navigationGridSystem->GridToWorldSpace(square, worldPosMin);
+        mesh.vertices[vertexIndex * 3] = worldPosMin.x;
+        mesh.vertices[vertexIndex * 3 + 1] = navigationGridSystem->GetTerrainHeight(square) +
                                              0.3; // Little buffer so the overlay doesnt blend into terrain
-        mesh.vertices[vertexIndex * 3 + 2] = gridSquares[gridRow][gridCol]->worldPosMin.z;
+        mesh.vertices[vertexIndex * 3 + 2] = worldPosMin.z;
     }
 
     void TextureTerrainOverlay::updateNormalData(Mesh& mesh, int vertexIndex, int gridRow, int gridCol) const
     {
-        const auto& gridSquares = navigationGridSystem->GetGridSquares();
-        mesh.normals[vertexIndex * 3] = gridSquares[gridRow][gridCol]->terrainNormal.x;
-        mesh.normals[vertexIndex * 3 + 1] = gridSquares[gridRow][gridCol]->terrainNormal.y;
-        mesh.normals[vertexIndex * 3 + 2] = gridSquares[gridRow][gridCol]->terrainNormal.z;
+        const auto normal = navigationGridSystem->GetTerrainNormal({gridRow, gridCol});
+        mesh.normals[vertexIndex * 3] = normal.x;
+        mesh.normals[vertexIndex * 3 + 1] = normal.y;
+        mesh.normals[vertexIndex * 3 + 2] = normal.z;
     }
 
     void TextureTerrainOverlay::updateTexCoordData(
@@ -152,15 +154,12 @@ namespace sage
         renderable.SetModel(generateTerrainPolygon(minRange, maxRange));
 
         // Calculate the center of the mesh in world space
-        const auto& gridSquares = navigationGridSystem->GetGridSquares();
+        const auto minSquare = navigationGridSystem->GetGridSquare(minRange.row, minRange.col);
+        const auto maxSquare = navigationGridSystem->GetGridSquare(maxRange.row - 1, maxRange.col - 1);
         const Vector3 meshMin = {
-            gridSquares[minRange.row][minRange.col]->worldPosMin.x,
-            gridSquares[minRange.row][minRange.col]->GetTerrainHeight(),
-            gridSquares[minRange.row][minRange.col]->worldPosMin.z};
+            minSquare.worldPosMin.x, minSquare.GetTerrainHeight(), minSquare.worldPosMin.z};
         const Vector3 meshMax = {
-            gridSquares[maxRange.row - 1][maxRange.col - 1]->worldPosMax.x,
-            gridSquares[maxRange.row - 1][maxRange.col - 1]->GetTerrainHeight(),
-            gridSquares[maxRange.row - 1][maxRange.col - 1]->worldPosMax.z};
+            maxSquare.worldPosMax.x, maxSquare.GetTerrainHeight(), maxSquare.worldPosMax.z};
         const Vector3 meshCenter = {(meshMin.x + meshMax.x) * 0.5f, 0, (meshMin.z + meshMax.z) * 0.5f};
 
         // Calculate the offset to center the mesh on the mouse position
@@ -0,0 +1,166 @@
+#include "TriangleBvh.hpp"
+
+#include "raymath.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace sage
+{
+    namespace
+    {
+        constexpr uint32_t MAX_LEAF_SIZE = 4;
+        constexpr float TRIANGLE_EPSILON = 0.000001f; // As GetRayCollisionTriangle
+
+        // Möller-Trumbore, as GetRayCollisionTriangle. Returns the distance or a negative number.
+        float rayTriangle(const Ray& ray, const Vector3 a, const Vector3 b, const Vector3 c)
+        {
+            const Vector3 edge1 = Vector3Subtract(b, a);
+            const Vector3 edge2 = Vector3Subtract(c, a);
+            const Vector3 p = Vector3CrossProduct(ray.direction, edge2);
+            const float det = Vector3DotProduct(edge1, p);
+            if (det > -TRIANGLE_EPSILON && det < TRIANGLE_EPSILON) return -1;
+            const float invDet = 1.0f / det;
+            const Vector3 tv = Vector3Subtract(ray.position, a);
+            const float u = Vector3DotProduct(tv, p) * invDet;
+            if (u < 0.0f || u > 1.0f) return -1;
+            const Vector3 q = Vector3CrossProduct(tv, edge1);
+            const float v = Vector3DotProduct(ray.direction, q) * invDet;
+            if (v < 0.0f || u + v > 1.0f) return -1;
+            const float t = Vector3DotProduct(edge2, q) * invDet;
+            return t > TRIANGLE_EPSILON ? t : -1;
+        }
+    } // namespace
+
+    int TriangleBvh::intersect(const Ray& ray, float& distance) const
+    {
+        int closest = -1;
+        distance = std::numeric_limits<float>::max();
+        if (nodes.empty()) return closest;
+
+        const Vector3 inverseDirection{1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+        if (std::isinf(RayBoxEntry(ray.position, inverseDirection, nodes[0].min, nodes[0].max, distance)))
+            return closest;
+
+        // Nodes still to visit, with the distance the ray enters them at
+        std::array<std::pair<uint32_t, float>, BVH_MAX_DEPTH + 1> stack{};
+        int top = 0;
+        stack[top++] = {0, 0.0f};
+        while (top > 0)
+        {
+            const auto [nodeIndex, entry] = stack[--top];
+            if (entry > distance) continue; // A closer hit was found since it was pushed
+            const BvhNode& node = nodes[nodeIndex];
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    const float t = rayTriangle(ray, vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+                    if (t >= 0 && t < distance)
+                    {
+                        distance = t;
+                        closest = static_cast<int>(i);
+                    }
+                }
+                continue;
+            }
+
+            // Visit the nearer child first, so that the farther one can often be skipped
+            uint32_t nearIndex = nodeIndex + 1, farIndex = node.first;
+            float nearEntry =
+                RayBoxEntry(ray.position, inverseDirection, nodes[nearIndex].min, nodes[nearIndex].max, distance);
+            float farEntry =
+                RayBoxEntry(ray.position, inverseDirection, nodes[farIndex].min, nodes[farIndex].max, distance);
+            if (farEntry < nearEntry)
+            {
+                std::swap(nearIndex, farIndex);
+                std::swap(nearEntry, farEntry);
+            }
+            if (!std::isinf(farEntry)) stack[top++] = {farIndex, farEntry};
+            if (!std::isinf(nearEntry)) stack[top++] = {nearIndex, nearEntry};
+        }
+        return closest;
+    }
+
+    bool TriangleBvh::Empty() const
+    {
+        return nodes.empty();
+    }
+
+    size_t TriangleBvh::TriangleCount() const
+    {
+        return vertices.size() / 3;
+    }
+
+    RayCollision TriangleBvh::GetRayCollision(const Ray ray) const
+    {
+        RayCollision collision{};
+        float distance;
+        const int triangle = intersect(ray, distance);
+        if (triangle < 0) return collision;
+
+        const Vector3 a = vertices[triangle * 3], b = vertices[triangle * 3 + 1], c = vertices[triangle * 3 + 2];
+        collision.hit = true;
+        collision.distance = distance;
+        collision.normal = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(b, a), Vector3Subtract(c, a)));
+        collision.point = Vector3Add(ray.position, Vector3Scale(ray.direction, distance));
+        return collision;
+    }
+
+    RayCollision TriangleBvh::GetRayCollision(const Ray ray, const Matrix transform) const
+    {
+        // The direction is not normalised, so distances carry over between spaces
+        const Matrix inverse = MatrixInvert(transform);
+        Ray local;
+        local.position = Vector3Transform(ray.position, inverse);
+        local.direction =
+            Vector3Subtract(Vector3Transform(Vector3Add(ray.position, ray.direction), inverse), local.position);
+
+        RayCollision collision{};
+        float distance;
+        const int triangle = intersect(local, distance);
+        if (triangle < 0) return collision;
+
+        // The normal (and its winding) are taken from the triangle in world space, as GetRayCollisionMesh does
+        const Vector3 a = Vector3Transform(vertices[triangle * 3], transform);
+        const Vector3 b = Vector3Transform(vertices[triangle * 3 + 1], transform);
+        const Vector3 c = Vector3Transform(vertices[triangle * 3 + 2], transform);
+        collision.hit = true;
+        collision.distance = distance;
+        collision.normal = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(b, a), Vector3Subtract(c, a)));
+        collision.point = Vector3Add(ray.position, Vector3Scale(ray.direction, distance));
+        return collision;
+    }
+
+    TriangleBvh::TriangleBvh(const Mesh& mesh)
+    {
+        if (mesh.vertices == nullptr || mesh.triangleCount <= 0) return;
+
+        const auto triangleCount = static_cast<uint32_t>(mesh.triangleCount);
+        auto vertex = [&mesh](const uint32_t i) {
+            const uint32_t v = mesh.indices ? mesh.indices[i] : i;
+            return Vector3{mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2]};
+        };
+
+        std::vector<BvhBounds> triangleBounds(triangleCount);
+        for (uint32_t i = 0; i < triangleCount; ++i)
+        {
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                triangleBounds[i].Grow(vertex(i * 3 + corner));
+            }
+        }
+
+        std::vector<uint32_t> order;
+        nodes = BuildBvh(triangleBounds, MAX_LEAF_SIZE, order);
+        vertices.resize(static_cast<size_t>(triangleCount) * 3);
+        for (uint32_t i = 0; i < triangleCount; ++i)
+        {
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                vertices[i * 3 + corner] = vertex(order[i] * 3 + corner);
+            }
+        }
+    }
+} // namespace sage
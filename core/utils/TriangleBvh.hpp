@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Bvh.hpp"
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sage
+{
+    // BVH over a mesh's triangles in mesh space, replacing GetRayCollisionMesh's linear scan
+    class TriangleBvh
+    {
+        std::vector<BvhNode> nodes;
+        std::vector<Vector3> vertices; // Three per triangle, in node order
+
+        // Closest triangle hit by the ray (in mesh space), or -1. "distance" is in multiples of ray.direction.
+        [[nodiscard]] int intersect(const Ray& ray, float& distance) const;
+
+      public:
+        [[nodiscard]] bool Empty() const;
+        [[nodiscard]] size_t TriangleCount() const;
+        // Same result as GetRayCollisionMesh(ray, mesh, MatrixIdentity()).
+        [[nodiscard]] RayCollision GetRayCollision(Ray ray) const;
+        // Same result as GetRayCollisionMesh(ray, mesh, transform). The ray is moved into mesh space instead of
+        // the mesh into world space.
+        [[nodiscard]] RayCollision GetRayCollision(Ray ray, Matrix transform) const;
+
+        explicit TriangleBvh(const Mesh& mesh);
+        TriangleBvh() = default;
+    };
+} // namespace sage
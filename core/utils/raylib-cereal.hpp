@@ -12,6 +12,18 @@
 #include <array>
 #include <cstring>
 
+namespace sage::serializer
+{
+    inline bool headlessLoading = false;
+
+    // For tools that load maps without a window (e.g., navbench), and so have no GPU to upload textures and meshes
+    // to. Textures are replaced by the default texture, and meshes keep their data on the CPU.
+    inline void SetHeadlessLoading(const bool headless)
+    {
+        headlessLoading = headless;
+    }
+} // namespace sage::serializer
+
 template <typename Archive>
 void serialize(Archive& archive, Vector2& v2)
 {
@@ -311,7 +323,9 @@ void load(Archive& archive, MaterialMap& map)
 
         return;
     }
-    map.texture = LoadTextureFromImage(image);
+    map.texture = sage::serializer::headlessLoading
+                      ? Texture2D{rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8}
+                      : LoadTextureFromImage(image);
     UnloadImage(image);
 };
 
@@ -420,8 +434,11 @@ void load(Archive& archive, Model& model)
     if ((model.meshCount != 0) && (model.meshes != nullptr))
     {
         // Upload vertex data to GPU (static meshes)
-        for (int i = 0; i < model.meshCount; i++)
-            UploadMesh(&model.meshes[i], false);
+        if (!sage::serializer::headlessLoading)
+        {
+            for (int i = 0; i < model.meshCount; i++)
+                UploadMesh(&model.meshes[i], false);
+        }
     }
     else
         TRACELOG(LOG_WARNING, "MESH: [%s] Failed to load model mesh(es) data", "Cereal Model Import");
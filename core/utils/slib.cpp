@@ -182,11 +182,27 @@ namespace sage
         return *bb;
     }
 
+    const TriangleBvh& ModelSafe::GetMeshBvh(int meshNum) const
+    {
+        assert(meshNum < GetMeshCount());
+        meshBvhs.resize(rlmodel.meshCount);
+        auto& bvh = meshBvhs[meshNum];
+        if (!bvh)
+        {
+            const auto& mesh = rlmodel.meshes[meshNum];
+            bvh = ResourceManager::GetInstance().GetMeshBvh(modelKey, meshNum, mesh);
+            // Deep copies (and models not loaded through the ResourceManager) build their own
+            if (!bvh) bvh = std::make_shared<const TriangleBvh>(mesh);
+        }
+        return *bvh;
+    }
+
     RayCollision ModelSafe::GetRayMeshCollision(Ray ray, int meshNum, Matrix transform) const
     {
         assert(meshNum < GetMeshCount());
         Matrix mat = MatrixMultiply(rlmodel.transform, transform);
-        return GetRayCollisionMesh(ray, rlmodel.meshes[meshNum], mat);
+        // Same result as GetRayCollisionMesh, without testing every triangle
+        return GetMeshBvh(meshNum).GetRayCollision(ray, mat);
     }
 
     void ModelSafe::UpdateAnimation(ModelAnimation anim, int frame) const
@@ -337,6 +353,7 @@ namespace sage
         // Reset the source object's model to prevent double deletion
         memorySafe = other.memorySafe;
         modelKey = other.modelKey;
+        meshBvhs = std::move(other.meshBvhs);
         other.rlmodel = {};
     }
 
@@ -351,6 +368,7 @@ namespace sage
             rlmodel = other.rlmodel;
             memorySafe = other.memorySafe;
             modelKey = other.modelKey;
+            meshBvhs = std::move(other.meshBvhs);
 
             // Reset the source object's model
             other.rlmodel = {};
@@ -7,9 +7,12 @@
 #include "common_types.hpp"
 #include "raylib-cereal.hpp"
 #include "raylib.h"
+#include "TriangleBvh.hpp"
 
 #include "entt/entt.hpp"
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <optional>
 
@@ -61,6 +64,8 @@ namespace sage
         Model rlmodel{};
         std::string modelKey{}; // The key/path of the model in the ResourceManager
         bool memorySafe = true;
+        // Per mesh, for ray casts. Filled on first use, from the ResourceManager where possible.
+        mutable std::vector<std::shared_ptr<const TriangleBvh>> meshBvhs;
 
         void UnloadShaderLocs() const;
         void UnloadMaterials() const;
@@ -70,6 +75,8 @@ namespace sage
         [[nodiscard]] const Mesh& GetMesh(int num) const;
         [[nodiscard]] BoundingBox CalcLocalMeshBoundingBox(const Mesh& mesh, bool& success) const;
         [[nodiscard]] BoundingBox CalcLocalBoundingBox() const;
+        // Triangle BVH of the mesh (in mesh space). Shared by every shallow copy of the model.
+        [[nodiscard]] const TriangleBvh& GetMeshBvh(int meshNum) const;
         [[nodiscard]] RayCollision GetRayMeshCollision(Ray ray, int meshNum, Matrix transform) const;
         void UpdateAnimation(ModelAnimation anim, int frame) const;
         void Draw(Vector3 position, float scale, Color tint) const;
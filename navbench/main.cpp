@@ -0,0 +1,317 @@
+#include "components/Collideable.hpp"
+#include "components/sgTransform.hpp"
+#include "ResourceManager.hpp"
+#include "Serializer.hpp"
+#include "systems/CollisionSystem.hpp"
+#include "systems/navigation/PathCache.hpp"
+#include "systems/navigation/PathfindingContext.hpp"
+#include "systems/NavigationGridSystem.hpp"
+
+#include "cereal/archives/json.hpp"
+#include "cereal/cereal.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+#include "entt/entt.hpp"
+#include "raylib.h"
+#include "raymath.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Every allocation made through operator new is counted, so that queries that allocate per call show up in the
+// report. (Allocations made by raylib through malloc are not counted.)
+namespace
+{
+    std::atomic<uint64_t> allocationCount{0};
+}
+
+void* operator new(const std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    using namespace sage;
+
+    // Roughly the bounds of an actor
+    constexpr BoundingBox PROBE_BOUNDS{{-0.5f, 0.0f, -0.5f}, {0.5f, 2.0f, 0.5f}};
+    constexpr int MAX_PICK_ATTEMPTS = 1000;
+
+    struct QueryPair
+    {
+        GridSquare start;
+        GridSquare finish;
+        Vector3 startPos;
+        Vector3 finishPos;
+    };
+
+    struct QuerySample
+    {
+        double microseconds = 0;
+        int nodesExpanded = 0;
+        double pathLength = 0;
+        uint64_t allocations = 0;
+        bool cacheHit = false;
+        bool found = false;
+    };
+
+    // What a single query reports back
+    struct QueryResult
+    {
+        bool found = false; // Found a path, a location or a hit
+        int nodesExpanded = 0;
+        double pathLength = 0; // World units from the start position through every waypoint
+    };
+
+    struct QueryReport
+    {
+        std::string name;
+        int queries = 0;
+        int found = 0;
+        double p50Us = 0;
+        double p99Us = 0;
+        double maxUs = 0;
+        double meanNodesExpanded = 0;
+        double meanPathLength = 0; // Over the queries that found a path
+        double meanAllocations = 0;
+        uint64_t maxAllocations = 0;
+        int cacheHits = 0;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(
+                cereal::make_nvp("name", name),
+                cereal::make_nvp("queries", queries),
+                cereal::make_nvp("found", found),
+                cereal::make_nvp("p50_us", p50Us),
+                cereal::make_nvp("p99_us", p99Us),
+                cereal::make_nvp("max_us", maxUs),
+                cereal::make_nvp("mean_nodes_expanded", meanNodesExpanded),
+                cereal::make_nvp("mean_path_length", meanPathLength),
+                cereal::make_nvp("mean_allocations", meanAllocations),
+                cereal::make_nvp("max_allocations", maxAllocations),
+                cereal::make_nvp("cache_hits", cacheHits));
+        }
+    };
+
+    // raylib logs to stdout, which is reserved for the report
+    void logToStderr(const int, const char* text, va_list args)
+    {
+        std::vfprintf(stderr, text, args);
+        std::fputc('\n', stderr);
+    }
+
+    double percentile(std::vector<double> sorted, const double p)
+    {
+        if (sorted.empty()) return 0;
+        std::ranges::sort(sorted);
+        const auto idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(idx, sorted.size() - 1)];
+    }
+
+    QueryReport summarise(std::string name, const std::vector<QuerySample>& samples)
+    {
+        QueryReport report;
+        report.name = std::move(name);
+        report.queries = static_cast<int>(samples.size());
+        if (samples.empty()) return report;
+
+        std::vector<double> times;
+        times.reserve(samples.size());
+        for (const auto& sample : samples)
+        {
+            times.push_back(sample.microseconds);
+            report.meanNodesExpanded += sample.nodesExpanded;
+            if (sample.found) report.meanPathLength += sample.pathLength;
+            report.meanAllocations += static_cast<double>(sample.allocations);
+            report.maxAllocations = std::max(report.maxAllocations, sample.allocations);
+            report.cacheHits += sample.cacheHit;
+            report.found += sample.found;
+        }
+        report.p50Us = percentile(times, 0.5);
+        report.p99Us = percentile(times, 0.99);
+        report.maxUs = *std::ranges::max_element(times);
+        report.meanNodesExpanded /= static_cast<double>(samples.size());
+        if (report.found > 0) report.meanPathLength /= report.found;
+        report.meanAllocations /= static_cast<double>(samples.size());
+        return report;
+    }
+
+    std::vector<QuerySample> run(
+        const NavigationGridSystem& navigation,
+        const std::vector<QueryPair>& pairs,
+        const std::function<QueryResult(const QueryPair&)>& query)
+    {
+        std::vector<QuerySample> samples;
+        samples.reserve(pairs.size());
+        for (const auto& pair : pairs)
+        {
+            const auto hitsBefore = navigation.GetPathCacheStats().hits;
+            const auto allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+
+            const auto result = query(pair);
+
+            const auto end = std::chrono::steady_clock::now();
+            QuerySample sample;
+            sample.allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            sample.microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+            sample.cacheHit = navigation.GetPathCacheStats().hits != hitsBefore;
+            sample.found = result.found;
+            sample.pathLength = result.pathLength;
+            // A cached path expands nothing; the context still holds the previous search's count
+            sample.nodesExpanded = sample.cacheHit ? 0 : result.nodesExpanded;
+            samples.push_back(sample);
+        }
+        return samples;
+    }
+
+    // Start/finish pairs on squares the probe fits on, from a fixed seed so that every run replays the same set.
+    std::vector<QueryPair> pickPairs(const NavigationGridSystem& navigation, const int count, const unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, navigation.slices - 1);
+
+        const auto pickSquare = [&](GridSquare& out) {
+            for (int attempt = 0; attempt < MAX_PICK_ATTEMPTS; ++attempt)
+            {
+                out = {dist(rng), dist(rng)};
+                if (navigation.CheckBoundingBoxAreaUnoccupied(out, PROBE_BOUNDS)) return true;
+            }
+            return false;
+        };
+
+        std::vector<QueryPair> pairs;
+        pairs.reserve(count);
+        while (static_cast<int>(pairs.size()) < count)
+        {
+            QueryPair pair{};
+            if (!pickSquare(pair.start) || !pickSquare(pair.finish)) break;
+            if (pair.start == pair.finish) continue;
+            navigation.GridToWorldSpace(pair.start, pair.startPos);
+            navigation.GridToWorldSpace(pair.finish, pair.finishPos);
+            pairs.push_back(pair);
+        }
+        return pairs;
+    }
+} // namespace
+
+// Usage: navbench [map.bin] [pair count] [seed]
+// Loads a packed map without a window (and so without a GPU), replays the same start/finish pairs through each
+// navigation query and prints the latency, nodes expanded, path length and allocations of each as JSON.
+int main(int argc, char* argv[])
+{
+    const char* mapPath = argc > 1 ? argv[1] : "resources/dungeon-map.bin";
+    const int pairCount = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1000;
+    const unsigned seed = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 1234u;
+
+    SetTraceLogCallback(logToStderr);
+    SetTraceLogLevel(LOG_WARNING);
+
+    entt::registry registry{};
+    CollisionSystem collisionSystem(&registry);
+    NavigationGridSystem navigation(&registry, &collisionSystem);
+
+    {
+        // LoadMap reports its progress on stdout
+        auto* out = std::cout.rdbuf(std::cerr.rdbuf());
+        serializer::SetHeadlessLoading(true);
+        serializer::LoadMap(&registry, mapPath);
+        const auto heightMap = ResourceManager::GetInstance().GetImage("HEIGHT_MAP");
+        const auto normalMap = ResourceManager::GetInstance().GetImage("NORMAL_MAP");
+        navigation.Init(heightMap.GetWidth(), 1.0f);
+        navigation.PopulateGrid(heightMap, normalMap);
+        std::cout.rdbuf(out);
+    }
+
+    // Created after the grid is populated, so that it does not occupy any squares itself
+    const auto probe = registry.create();
+    auto& probeTransform = registry.emplace<sgTransform>(probe, probe);
+    registry.emplace<Collideable>(probe, &registry, probe, PROBE_BOUNDS);
+
+    const auto pairs = pickPairs(navigation, pairCount, seed);
+    if (pairs.empty())
+    {
+        std::cerr << "ERROR: No walkable squares found in " << mapPath << std::endl;
+        return 1;
+    }
+
+    const auto searched = [](const Vector3& startPos, const std::vector<Vector3>& path) {
+        double length = 0;
+        Vector2 previous{startPos.x, startPos.z};
+        for (const auto& waypoint : path)
+        {
+            const Vector2 next{waypoint.x, waypoint.z};
+            length += Vector2Distance(previous, next);
+            previous = next;
+        }
+        return QueryResult{!path.empty(), PathfindingContext::ThreadLocal().ExpandedNodes(), length};
+    };
+    const auto astar = [&](const QueryPair& pair) {
+        return searched(pair.startPos, navigation.AStarPathfind(probe, pair.startPos, pair.finishPos));
+    };
+    const auto astarJps = [&](const QueryPair& pair) {
+        return searched(
+            pair.startPos,
+            navigation.AStarPathfind(probe, pair.startPos, pair.finishPos, AStarHeuristic::JUMP_POINT_SEARCH));
+    };
+    const auto bfs = [&](const QueryPair& pair) {
+        return searched(pair.startPos, navigation.BFSPathfind(probe, pair.startPos, pair.finishPos));
+    };
+    const auto nextBestLocation = [&](const QueryPair& pair) {
+        probeTransform.SetPosition(pair.startPos);
+        const auto square = navigation.FindNextBestLocation(probe, pair.finish);
+        return QueryResult{navigation.CheckBoundingBoxAreaUnoccupied(square, PROBE_BOUNDS, probe)};
+    };
+    const auto castRay = [&](const QueryPair& pair) {
+        const Vector2 delta{
+            static_cast<float>(pair.finish.col - pair.start.col),
+            static_cast<float>(pair.finish.row - pair.start.row)};
+        const auto hit = navigation.CastRay(pair.start.row, pair.start.col, delta, Vector2Length(delta), probe);
+        return QueryResult{hit != entt::null};
+    };
+
+    std::vector<QueryReport> reports;
+    reports.push_back(summarise("astar", run(navigation, pairs, astar)));
+    reports.push_back(summarise("astar_jps", run(navigation, pairs, astarJps)));
+    reports.push_back(summarise("bfs", run(navigation, pairs, bfs)));
+    reports.push_back(summarise("find_next_best_location", run(navigation, pairs, nextBestLocation)));
+    reports.push_back(summarise("cast_ray", run(navigation, pairs, castRay)));
+
+    {
+        cereal::JSONOutputArchive archive(std::cout);
+        archive(
+            cereal::make_nvp("map", std::string(mapPath)),
+            cereal::make_nvp("slices", navigation.slices),
+            cereal::make_nvp("seed", seed),
+            cereal::make_nvp("pairs", static_cast<int>(pairs.size())),
+            cereal::make_nvp("results", reports));
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
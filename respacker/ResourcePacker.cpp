@@ -21,6 +21,7 @@
 #include "raylib.h"
 #include "raymath.h"
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -363,9 +364,16 @@ namespace sage
         std::cout << "FINISH: Processing txt data into resource manager. \n";
 
         ImageSafe heightMap(false), normalMap(false);
+        Heightfield heightfield;
 
         navigationGridSystem->Init(slices, 1.0f);
+        const auto bakeStart = std::chrono::steady_clock::now();
         navigationGridSystem->InitGridHeightAndNormals();
+        const std::chrono::duration<double, std::milli> bakeTime = std::chrono::steady_clock::now() - bakeStart;
+        std::cout << "Baked terrain height and normals for " << slices << "x" << slices << " grid in "
+                  << bakeTime.count() << " ms \n";
+        navigationGridSystem->GenerateHeightfield(heightfield);
+        // Still packed, as the fallback for loading the grid (see Scene::initAssets)
         navigationGridSystem->GenerateHeightMap(heightMap);
         navigationGridSystem->GenerateNormalMap(normalMap);
 
@@ -374,6 +382,7 @@ namespace sage
 
         ResourceManager::GetInstance().ImageLoadFromFile("HEIGHT_MAP", heightMap.GetImage());
         ResourceManager::GetInstance().ImageLoadFromFile("NORMAL_MAP", normalMap.GetImage());
+        ResourceManager::GetInstance().HeightfieldLoad("HEIGHTFIELD", std::move(heightfield));
 
         serializer::SaveMap(*registry, output);
         std::cout << "FINISH: Constructing map into bin file. \n";
@@ -0,0 +1,111 @@
+#include "Check.hpp"
+
+#include "systems/NavigationGridSystem.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+#include "raymath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace sage;
+
+namespace
+{
+    // The first occupant along the ray, found by sampling the line densely
+    entt::entity sampledRay(
+        const std::vector<entt::entity>& occupants,
+        const int slices,
+        const int row,
+        const int col,
+        Vector2 direction,
+        const float distance)
+    {
+        direction = Vector2Normalize(direction);
+        const int samples = static_cast<int>(distance * 2000);
+        for (int i = 0; i <= samples; ++i)
+        {
+            const float t = distance * static_cast<float>(i) / static_cast<float>(samples);
+            const float y = static_cast<float>(row) + 0.5f + direction.y * t;
+            const float x = static_cast<float>(col) + 0.5f + direction.x * t;
+            // A ray through a corner only grazes the squares beside it, so CastRay does not report them
+            if (std::fabs(y - std::round(y)) < 1e-3f && std::fabs(x - std::round(x)) < 1e-3f) continue;
+            const int r = static_cast<int>(std::floor(y));
+            const int c = static_cast<int>(std::floor(x));
+            if (r < 0 || c < 0 || r >= slices || c >= slices) continue;
+            if (occupants[r * slices + c] != entt::null) return occupants[r * slices + c];
+        }
+        return entt::null;
+    }
+
+    void matchesSampledRay(const int slices)
+    {
+        entt::registry registry;
+        NavigationGridSystem navigation(&registry, nullptr);
+        navigation.Init(slices, 1.0f);
+
+        // Small blocks scattered over the grid
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> square(0, slices - 1);
+        std::uniform_int_distribution<int> size(0, 4);
+        std::vector<entt::entity> occupants(slices * slices, static_cast<entt::entity>(entt::null));
+        const float half = static_cast<float>(slices) / 2.0f;
+        for (int i = 0; i < slices * 2; ++i)
+        {
+            const auto entity = registry.create();
+            const int row = square(rng);
+            const int col = square(rng);
+            const int lastRow = std::min(row + size(rng), slices - 1);
+            const int lastCol = std::min(col + size(rng), slices - 1);
+            const BoundingBox box{
+                {static_cast<float>(col) - half + 0.1f, 0, static_cast<float>(row) - half + 0.1f},
+                {static_cast<float>(lastCol) - half + 0.9f, 1.0f, static_cast<float>(lastRow) - half + 0.9f}};
+            navigation.MarkSquareAreaOccupied(box, true, entity);
+            for (int r = row; r <= lastRow; ++r)
+            {
+                for (int c = col; c <= lastCol; ++c)
+                {
+                    occupants[r * slices + c] = entity;
+                }
+            }
+        }
+
+        std::uniform_real_distribution<float> angle(0, 2 * std::numbers::pi_v<float>);
+        std::uniform_real_distribution<float> length(0.5f, 40.0f);
+        for (int i = 0; i < 1500; ++i)
+        {
+            const int row = square(rng);
+            const int col = square(rng);
+            // Every fourth ray runs along a row, column or diagonal
+            const float a =
+                i % 4 == 0 ? static_cast<float>(rng() % 8) * std::numbers::pi_v<float> / 4 : angle(rng);
+            const Vector2 direction{std::cos(a), std::sin(a)};
+            const float distance = length(rng);
+
+            const auto hit = navigation.CastRay(row, col, direction, distance);
+            CHECK(hit == sampledRay(occupants, slices, row, col, direction, distance));
+
+            // Capturing debug squares does not change the hit
+            std::vector<GridSquare> debugLines;
+            CHECK(navigation.CastRay(row, col, direction, distance, entt::null, &debugLines) == hit);
+
+            // The hit entity can be ignored
+            if (hit != entt::null)
+            {
+                CHECK(navigation.CastRay(row, col, direction, distance, hit) != hit);
+            }
+        }
+    }
+} // namespace
+
+int main()
+{
+    matchesSampledRay(64);
+    matchesSampledRay(200);
+    matchesSampledRay(1100);
+    return test::failures;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdio>
+
+namespace sage::test
+{
+    inline int failures = 0;
+} // namespace sage::test
+
+// Unlike assert, still checks in release builds. Tests return sage::test::failures from main.
+#define CHECK(condition)                                                                                          \
+    do                                                                                                            \
+    {                                                                                                             \
+        if (!(condition))                                                                                         \
+        {                                                                                                         \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                             \
+            ++sage::test::failures;                                                                               \
+        }                                                                                                         \
+    } while (false)
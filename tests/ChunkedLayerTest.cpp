@@ -0,0 +1,88 @@
+#include "Check.hpp"
+
+#include "systems/navigation/ChunkedLayer.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace sage;
+
+namespace
+{
+    constexpr int CHUNK_SIZE = ChunkedLayer<int>::CHUNK_SIZE;
+
+    // Random writes read back the same as a flat array, on a grid that does not divide into whole chunks
+    void matchesFlatArray()
+    {
+        constexpr int slices = 200;
+        ChunkedLayer<int> layer;
+        layer.Init(slices, 1);
+        std::vector<int> flat(slices * slices, 1);
+
+        std::mt19937 rng(3);
+        std::uniform_int_distribution<int> square(0, slices - 1);
+        std::uniform_int_distribution<int> value(0, 3);
+        for (int i = 0; i < 20000; ++i)
+        {
+            const GridSquare at{square(rng), square(rng)};
+            const int v = value(rng);
+            layer.Set(at, v);
+            flat[at.row * slices + at.col] = v;
+        }
+        for (int row = 0; row < slices; ++row)
+        {
+            for (int col = 0; col < slices; ++col)
+            {
+                CHECK(layer.Get({row, col}) == flat[row * slices + col]);
+            }
+        }
+
+        int changed = 0;
+        layer.ForEachChanged([&](const GridSquare at, const int v) {
+            CHECK(v != 1);
+            CHECK(flat[at.row * slices + at.col] == v);
+            ++changed;
+        });
+        CHECK(changed == static_cast<int>(std::ranges::count_if(flat, [](const int v) { return v != 1; })));
+
+        // Only the chunks overlapping the range are copied
+        const auto copy = layer.CopyRange({10, 70}, {60, 130});
+        CHECK(copy.AllocatedChunkCount() == 2);
+        CHECK(copy.Get({20, 100}) == flat[20 * slices + 100]);
+        CHECK(copy.Get({150, 150}) == 1);
+    }
+
+    // A chunk is allocated by its first non-fill square and freed when its last one is reset
+    void allocatesOnlyChangedChunks()
+    {
+        ChunkedLayer<int> layer;
+        layer.Init(CHUNK_SIZE * 4, 0);
+        CHECK(layer.AllocatedChunkCount() == 0);
+
+        layer.Set({0, 0}, 0);
+        CHECK(layer.AllocatedChunkCount() == 0);
+        layer.Set({5, 5}, 7);
+        layer.Set({6, 6}, 7);
+        layer.Set({CHUNK_SIZE * 3, CHUNK_SIZE}, 2);
+        CHECK(layer.AllocatedChunkCount() == 2);
+
+        layer.Set({5, 5}, 8);
+        layer.Set({5, 5}, 0);
+        CHECK(layer.AllocatedChunkCount() == 2);
+        layer.Set({6, 6}, 0);
+        CHECK(layer.AllocatedChunkCount() == 1);
+        CHECK(layer.Get({6, 6}) == 0);
+
+        layer.Clear();
+        CHECK(layer.AllocatedChunkCount() == 0);
+        CHECK(layer.Get({CHUNK_SIZE * 3, CHUNK_SIZE}) == 0);
+    }
+} // namespace
+
+int main()
+{
+    matchesFlatArray();
+    allocatesOnlyChangedChunks();
+    return test::failures;
+}
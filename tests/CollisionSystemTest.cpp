@@ -0,0 +1,110 @@
+#include "Check.hpp"
+
+#include "components/Collideable.hpp"
+#include "systems/CollisionSystem.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+#include "raymath.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace sage;
+
+namespace
+{
+    constexpr std::array LAYERS{
+        CollisionLayer::BUILDING, CollisionLayer::ENEMY, CollisionLayer::NPC, CollisionLayer::NAVIGATION};
+
+    entt::entity addCollideable(entt::registry& registry, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> halfSize(0.3f, 3.0f);
+        const Vector3 centre{position(rng), 0, position(rng)};
+        const Vector3 half{halfSize(rng), halfSize(rng), halfSize(rng)};
+
+        const auto entity = registry.create();
+        auto& collideable = registry.emplace<Collideable>(
+            entity, BoundingBox{Vector3Subtract(centre, half), Vector3Add(centre, half)}, MatrixIdentity());
+        collideable.collisionLayer = LAYERS[rng() % LAYERS.size()];
+        return entity;
+    }
+
+    // The distances of every bounding box hit, nearest first
+    std::vector<float> bruteForceHits(
+        entt::registry& registry,
+        const CollisionSystem& collisionSystem,
+        const entt::entity caster,
+        const Ray& ray,
+        const CollisionLayer layer)
+    {
+        const auto& collidesWith = collisionSystem.collisionMatrix[static_cast<int>(layer)];
+        std::vector<float> distances;
+        for (const auto& [entity, collideable] : registry.view<Collideable>().each())
+        {
+            if (entity == caster || !collidesWith[static_cast<int>(collideable.collisionLayer)]) continue;
+            const auto collision = GetRayCollisionBox(ray, collideable.worldBoundingBox);
+            if (collision.hit) distances.push_back(collision.distance);
+        }
+        std::ranges::sort(distances);
+        return distances;
+    }
+
+    void keepsTheNearestHits()
+    {
+        entt::registry registry;
+        CollisionSystem collisionSystem(&registry);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+        std::vector<entt::entity> entities;
+        for (int i = 0; i < 800; ++i)
+        {
+            entities.push_back(addCollideable(registry, rng));
+        }
+        collisionSystem.BuildStaticBvh();
+        // Created after the BVH was built, so held in the dynamic tree
+        for (int i = 0; i < 200; ++i)
+        {
+            entities.push_back(addCollideable(registry, rng));
+        }
+
+        std::array<CollisionInfo, 8> buffer{};
+        for (int query = 0; query < 300; ++query)
+        {
+            const Ray ray{
+                {position(rng), 0.5f, position(rng)},
+                Vector3Normalize({direction(rng), direction(rng) * 0.05f, direction(rng)})};
+            const auto caster = entities[rng() % entities.size()];
+            const auto layer = query % 2 == 0 ? CollisionLayer::DEFAULT : CollisionLayer::PLAYER;
+            const std::span out(buffer.data(), 1 + rng() % buffer.size());
+
+            const auto expected = bruteForceHits(registry, collisionSystem, caster, ray, layer);
+            const auto count = collisionSystem.GetCollisionsWithRay(caster, ray, out, layer);
+            CHECK(count == std::min(out.size(), expected.size()));
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK(std::fabs(out[i].rlCollision.distance - expected[i]) < 1e-4f);
+                CHECK(out[i].collidedEntityId != caster);
+                CHECK(collisionSystem.collisionMatrix[static_cast<int>(layer)]
+                                                     [static_cast<int>(out[i].collisionLayer)]);
+            }
+        }
+
+        // Nothing is written to an empty span
+        const Ray ray{{-100.0f, 0.5f, 0}, {1.0f, 0, 0}};
+        CHECK(collisionSystem.GetCollisionsWithRay(entt::null, ray, std::span<CollisionInfo>{}) == 0);
+    }
+} // namespace
+
+int main()
+{
+    keepsTheNearestHits();
+    return test::failures;
+}
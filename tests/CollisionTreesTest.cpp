@@ -0,0 +1,255 @@
+#include "Check.hpp"
+
+#include "systems/collision/DynamicAabbTree.hpp"
+#include "systems/collision/StaticBvh.hpp"
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace sage;
+
+namespace
+{
+    constexpr int LAYER_COUNT = static_cast<int>(CollisionLayer::COUNT);
+
+    CollisionProxy randomProxy(std::mt19937& rng, const int id, const float extent)
+    {
+        std::uniform_real_distribution<float> position(-extent, extent);
+        std::uniform_real_distribution<float> halfSize(0.2f, 4.0f);
+        std::uniform_int_distribution<int> layer(0, LAYER_COUNT - 1);
+        const Vector3 centre{position(rng), position(rng) * 0.05f, position(rng)};
+        const Vector3 half{halfSize(rng), halfSize(rng), halfSize(rng)};
+        return {
+            static_cast<entt::entity>(id),
+            {Vector3Subtract(centre, half), Vector3Add(centre, half)},
+            static_cast<CollisionLayer>(layer(rng))};
+    }
+
+    BoundingBox randomBox(std::mt19937& rng, const float extent)
+    {
+        std::uniform_real_distribution<float> position(-extent, extent);
+        std::uniform_real_distribution<float> halfSize(1.0f, 12.0f);
+        const Vector3 centre{position(rng), 0, position(rng)};
+        const Vector3 half{halfSize(rng), halfSize(rng), halfSize(rng)};
+        return {Vector3Subtract(centre, half), Vector3Add(centre, half)};
+    }
+
+    Ray randomRay(std::mt19937& rng, const float extent)
+    {
+        std::uniform_real_distribution<float> position(-extent, extent);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        return {{position(rng), 1.0f, position(rng)}, Vector3Normalize({direction(rng), 0.1f, direction(rng)})};
+    }
+
+    bool inMask(const CollisionProxy& proxy, const CollisionLayerMask layers)
+    {
+        return (LayerBit(proxy.layer) & layers) != 0;
+    }
+
+    // Checks every box and ray query of "tree" against testing each proxy in "live" in turn
+    template <typename Tree>
+    void matchesBruteForce(
+        const Tree& tree, const std::map<int, CollisionProxy>& live, std::mt19937& rng, const float extent)
+    {
+        for (int query = 0; query < 200; ++query)
+        {
+            const CollisionLayerMask layers = rng();
+
+            const auto box = randomBox(rng, extent);
+            std::set<int> expected;
+            std::set<int> found;
+            for (const auto& [id, proxy] : live)
+            {
+                if (inMask(proxy, layers) && CheckCollisionBoxes(box, proxy.box)) expected.insert(id);
+            }
+            tree.QueryBox(box, layers, [&found](const CollisionProxy& proxy) {
+                found.insert(static_cast<int>(proxy.entity));
+                return true;
+            });
+            CHECK(found == expected);
+
+            // Every hit, without pruning
+            const auto ray = randomRay(rng, extent);
+            expected.clear();
+            found.clear();
+            for (const auto& [id, proxy] : live)
+            {
+                if (inMask(proxy, layers) && GetRayCollisionBox(ray, proxy.box).hit) expected.insert(id);
+            }
+            float maxDistance = std::numeric_limits<float>::max();
+            tree.QueryRay(ray, layers, maxDistance, [&](const CollisionProxy& proxy) {
+                if (GetRayCollisionBox(ray, proxy.box).hit) found.insert(static_cast<int>(proxy.entity));
+                return true;
+            });
+            CHECK(found == expected);
+
+            // The nearest hit, lowering maxDistance as hits come in
+            float nearestExpected = std::numeric_limits<float>::max();
+            for (const auto& [id, proxy] : live)
+            {
+                if (!inMask(proxy, layers)) continue;
+                const auto collision = GetRayCollisionBox(ray, proxy.box);
+                if (collision.hit) nearestExpected = std::min(nearestExpected, collision.distance);
+            }
+            float nearestFound = std::numeric_limits<float>::max();
+            maxDistance = std::numeric_limits<float>::max();
+            tree.QueryRay(ray, layers, maxDistance, [&](const CollisionProxy& proxy) {
+                const auto collision = GetRayCollisionBox(ray, proxy.box);
+                if (collision.hit && collision.distance < nearestFound)
+                {
+                    nearestFound = collision.distance;
+                    maxDistance = nearestFound;
+                }
+                return true;
+            });
+            CHECK(std::fabs(nearestFound - nearestExpected) < 1e-4f);
+        }
+    }
+
+    void staticBvhMatchesBruteForce()
+    {
+        constexpr float extent = 150.0f;
+        std::mt19937 rng(7);
+        std::map<int, CollisionProxy> live;
+        std::vector<CollisionProxy> proxies;
+        for (int id = 0; id < 2000; ++id)
+        {
+            live[id] = randomProxy(rng, id, extent);
+            proxies.push_back(live[id]);
+        }
+
+        StaticBvh bvh;
+        bvh.Build(proxies);
+        CHECK(bvh.Size() == live.size());
+        matchesBruteForce(bvh, live, rng, extent);
+
+        // Refit after moves and layer changes, and drop removed proxies
+        for (int id = 0; id < 2000; id += 3)
+        {
+            auto& proxy = live[id];
+            proxy.box.max.y += 2.0f;
+            proxy.layer = static_cast<CollisionLayer>((static_cast<int>(proxy.layer) + 1) % LAYER_COUNT);
+            bvh.Update(proxy.entity, proxy.box, proxy.layer);
+        }
+        for (int id = 1; id < 2000; id += 5)
+        {
+            bvh.Remove(static_cast<entt::entity>(id));
+            live.erase(id);
+        }
+        CHECK(!bvh.Contains(static_cast<entt::entity>(1)));
+        CHECK(bvh.Contains(static_cast<entt::entity>(0)));
+        matchesBruteForce(bvh, live, rng, extent);
+    }
+
+    void dynamicTreeMatchesBruteForce()
+    {
+        constexpr float extent = 80.0f;
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+        std::map<int, CollisionProxy> live;
+        DynamicAabbTree tree;
+        int nextId = 0;
+        for (; nextId < 1000; ++nextId)
+        {
+            live[nextId] = randomProxy(rng, nextId, extent);
+            tree.Insert(live[nextId]);
+        }
+
+        for (int frame = 0; frame < 20; ++frame)
+        {
+            for (auto& [id, proxy] : live)
+            {
+                const Vector3 offset{step(rng), 0, step(rng)};
+                proxy.box = {Vector3Add(proxy.box.min, offset), Vector3Add(proxy.box.max, offset)};
+                tree.Move(proxy.entity, proxy.box);
+            }
+            for (int i = 0; i < 10; ++i)
+            {
+                auto it = live.begin();
+                std::advance(it, rng() % live.size());
+                if (i % 2 == 0)
+                {
+                    tree.Remove(it->second.entity);
+                    live.erase(it);
+                    continue;
+                }
+                it->second.layer = static_cast<CollisionLayer>(rng() % LAYER_COUNT);
+                tree.SetLayer(it->second.entity, it->second.layer);
+                live[nextId] = randomProxy(rng, nextId, extent);
+                tree.Insert(live[nextId]);
+                ++nextId;
+            }
+            CHECK(tree.Size() == live.size());
+            matchesBruteForce(tree, live, rng, extent);
+        }
+    }
+
+    // Subtrees whose layers are all outside the mask are never visited
+    template <typename Tree>
+    void prunesOtherLayers(const Tree& tree, const BoundingBox& everything)
+    {
+        int visited = 0;
+        auto count = [&visited](const CollisionProxy&) {
+            ++visited;
+            return true;
+        };
+        tree.QueryBox(everything, 0, count);
+        CHECK(visited == 0);
+        tree.QueryBox(everything, LayerBit(CollisionLayer::ENEMY), [&visited](const CollisionProxy& proxy) {
+            CHECK(proxy.layer == CollisionLayer::ENEMY);
+            ++visited;
+            return true;
+        });
+        CHECK(visited == 1);
+
+        visited = 0;
+        float maxDistance = std::numeric_limits<float>::max();
+        const Ray ray{{-1000.0f, 0.5f, 0.5f}, {1.0f, 0, 0}};
+        tree.QueryRay(ray, LayerBit(CollisionLayer::NPC), maxDistance, count);
+        CHECK(visited == 0);
+        const auto enemiesAndBuildings = LayerBit(CollisionLayer::ENEMY) | LayerBit(CollisionLayer::BUILDING);
+        tree.QueryRay(ray, enemiesAndBuildings, maxDistance, count);
+        CHECK(visited == 101);
+    }
+
+    void layerBitsPruneQueries()
+    {
+        // A row of buildings with a single enemy in the middle
+        std::vector<CollisionProxy> proxies;
+        for (int i = 0; i < 101; ++i)
+        {
+            const auto x = static_cast<float>(i);
+            proxies.push_back(
+                {static_cast<entt::entity>(i),
+                 {{x, 0, 0}, {x + 0.5f, 1.0f, 1.0f}},
+                 i == 50 ? CollisionLayer::ENEMY : CollisionLayer::BUILDING});
+        }
+        const BoundingBox everything{{-1.0f, -1.0f, -1.0f}, {200.0f, 2.0f, 2.0f}};
+
+        StaticBvh bvh;
+        bvh.Build(proxies);
+        prunesOtherLayers(bvh, everything);
+
+        DynamicAabbTree tree;
+        for (const auto& proxy : proxies)
+        {
+            tree.Insert(proxy);
+        }
+        prunesOtherLayers(tree, everything);
+    }
+} // namespace
+
+int main()
+{
+    staticBvhMatchesBruteForce();
+    dynamicTreeMatchesBruteForce();
+    layerBitsPruneQueries();
+    return test::failures;
+}
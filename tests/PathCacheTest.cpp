@@ -0,0 +1,92 @@
+#include "Check.hpp"
+
+#include "systems/navigation/PathCache.hpp"
+
+#include <vector>
+
+using namespace sage;
+
+namespace
+{
+    constexpr int SLICES = 256;
+
+    // A straight path along a row, from col "from" to col "to" (inclusive).
+    std::vector<GridSquare> rowPath(const int row, const int from, const int to)
+    {
+        std::vector<GridSquare> squares;
+        for (int col = from; col <= to; ++col)
+        {
+            squares.push_back({row, col});
+        }
+        return squares;
+    }
+
+    PathCacheKey keyFor(const GridSquare finish)
+    {
+        return {finish, {0, 0}, PathSearchType::HIERARCHICAL};
+    }
+
+    void findsTheRestOfAPath()
+    {
+        PathCache cache;
+        cache.Init(SLICES);
+        cache.Insert(keyFor({40, 50}), rowPath(40, 10, 50));
+
+        std::vector<GridSquare> squares;
+        CHECK(cache.Find(keyFor({40, 50}), {40, 30}, squares));
+        CHECK(squares == rowPath(40, 30, 50));
+        CHECK(!cache.Find(keyFor({40, 50}), {41, 30}, squares)); // Not on the path
+        CHECK(!cache.Find(keyFor({40, 51}), {40, 30}, squares)); // Different finish
+    }
+
+    void changesNearThePathInvalidateIt()
+    {
+        PathCache cache;
+        cache.Init(SLICES);
+        std::vector<GridSquare> squares;
+
+        // The path covers regions (2, 0) to (2, 3), so rows 16 to 63 and cols 0 to 79 are watched
+        cache.Insert(keyFor({40, 50}), rowPath(40, 10, 50));
+        cache.MarkChanged({100, 100}, {101, 101});
+        CHECK(cache.Find(keyFor({40, 50}), {40, 10}, squares));
+        cache.MarkChanged({200, 10}, {200, 10});
+        CHECK(cache.Find(keyFor({40, 50}), {40, 10}, squares));
+
+        // A neighbouring region, e.g., a door opening beside the path
+        cache.MarkChanged({60, 70}, {60, 70});
+        CHECK(!cache.Find(keyFor({40, 50}), {40, 10}, squares));
+
+        // Only changes made before the path was stored count against it
+        cache.Insert(keyFor({40, 50}), rowPath(40, 10, 50));
+        CHECK(cache.Find(keyFor({40, 50}), {40, 10}, squares));
+    }
+
+    void evictsTheLeastRecentlyUsedPath()
+    {
+        constexpr int capacity = 128;
+
+        PathCache cache;
+        cache.Init(SLICES);
+        std::vector<GridSquare> squares;
+
+        for (int i = 0; i < capacity; ++i)
+        {
+            cache.Insert(keyFor({i, 1}), rowPath(i, 0, 1));
+        }
+        CHECK(cache.Find(keyFor({0, 1}), {0, 0}, squares)); // Now the most recently used
+
+        cache.Insert(keyFor({capacity, 1}), rowPath(capacity, 0, 1));
+        CHECK(cache.Find(keyFor({0, 1}), {0, 0}, squares));
+        CHECK(!cache.Find(keyFor({1, 1}), {1, 0}, squares));
+        CHECK(cache.Find(keyFor({2, 1}), {2, 0}, squares));
+        CHECK(cache.Find(keyFor({capacity, 1}), {capacity, 0}, squares));
+    }
+} // namespace
+
+int main()
+{
+    findsTheRestOfAPath();
+    changesNearThePathInvalidateIt();
+    evictsTheLeastRecentlyUsedPath();
+    return test::failures;
+}